@@ -0,0 +1,186 @@
+#ifndef ULTREALITY_RENDERING_PARALLEL_FOR_H
+#define ULTREALITY_RENDERING_PARALLEL_FOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace UltReality::Rendering::Parallel
+{
+	/// <summary>
+	/// Get the number of threads the CPU side rendering routines spread their work over
+	/// </summary>
+	inline size_t WorkerCount() noexcept
+	{
+		return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	namespace Detail
+	{
+		using ChunkFunc = void (*)(void* context, size_t begin, size_t end);
+
+		/// <summary>
+		/// Persistent workers shared by every ParallelFor, so per-frame passes do not pay for creating threads. 
+		/// Runs one range at a time, a ParallelFor issued while another is running executes on the calling thread
+		/// </summary>
+		class WorkerPool
+		{
+		protected:
+			struct Job
+			{
+				ChunkFunc func;
+				void* context;
+				size_t count;
+				size_t grainSize;
+				size_t chunkCount;
+			};
+
+			std::vector<std::thread> m_threads;
+			std::mutex m_submit;	// Held by the thread whose range the pool is running
+			std::mutex m_mutex;
+			std::condition_variable m_wake;
+			std::condition_variable m_done;
+			Job m_job{};
+			std::atomic<size_t> m_nextChunk{ 0 };
+			uint64_t m_generation = 0;
+			size_t m_acknowledged = 0;	// Workers that have seen the current generation
+			size_t m_busy = 0;			// Workers inside the current job
+			bool m_stop = false;
+
+			void Work(const Job& job) noexcept
+			{
+				for (size_t chunk = m_nextChunk.fetch_add(1, std::memory_order_relaxed); chunk < job.chunkCount; chunk = m_nextChunk.fetch_add(1, std::memory_order_relaxed))
+				{
+					const size_t begin = chunk * job.grainSize;
+					job.func(job.context, begin, std::min(begin + job.grainSize, job.count));
+				}
+			}
+
+			void WorkerLoop() noexcept
+			{
+				uint64_t seen = 0;
+				std::unique_lock<std::mutex> lock(m_mutex);
+				while (true)
+				{
+					m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+					if (m_stop)
+						return;
+
+					// TryRun does not return before every worker has acknowledged the generation and left the job,
+					// so the job and its context stay alive until this worker reports done
+					seen = m_generation;
+					const Job job = m_job;
+					m_acknowledged++;
+					m_busy++;
+
+					lock.unlock();
+					Work(job);
+					lock.lock();
+
+					if (--m_busy == 0 && m_acknowledged == m_threads.size())
+						m_done.notify_all();
+				}
+			}
+
+		public:
+			/// <summary>
+			/// Start the workers
+			/// </summary>
+			/// <param name="threadCount">Number of threads besides the submitting thread</param>
+			explicit WorkerPool(size_t threadCount)
+			{
+				m_threads.reserve(threadCount);
+				for (size_t i = 0; i < threadCount; i++)
+					m_threads.emplace_back(&WorkerPool::WorkerLoop, this);
+			}
+
+			~WorkerPool()
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_stop = true;
+				}
+				m_wake.notify_all();
+
+				for (std::thread& thread : m_threads)
+					thread.join();
+			}
+
+			/// <summary>
+			/// Run a range across the workers and the calling thread
+			/// </summary>
+			/// <returns>False without running anything if the pool is already running a range</returns>
+			bool TryRun(size_t count, size_t grainSize, ChunkFunc func, void* context) noexcept
+			{
+				std::unique_lock<std::mutex> submit(m_submit, std::try_to_lock);
+				if (!submit.owns_lock() || m_threads.empty())
+					return false;
+
+				const Job job{ func, context, count, grainSize, (count + grainSize - 1) / grainSize };
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_job = job;
+					m_nextChunk.store(0, std::memory_order_relaxed);
+					m_acknowledged = 0;
+					m_generation++;
+				}
+				m_wake.notify_all();
+
+				Work(job);
+
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_done.wait(lock, [&] { return m_acknowledged == m_threads.size() && m_busy == 0; });
+
+				return true;
+			}
+		};
+
+		/// <summary>
+		/// Get the process wide pool, created on first use
+		/// </summary>
+		inline WorkerPool& Pool()
+		{
+			static WorkerPool pool(WorkerCount() - 1); // The submitting thread is the last worker
+			return pool;
+		}
+	}
+
+	/// <summary>
+	/// Split the range [0, count) into chunks of grainSize and invoke func(begin, end) for each chunk across the available cores. 
+	/// The calling thread participates and the call returns once every chunk has been processed. Calls made while another range is running,
+	/// including from inside func, run on the calling thread. func must not throw
+	/// </summary>
+	/// <param name="count">Number of items in the range</param>
+	/// <param name="grainSize">Number of items handed to func at a time</param>
+	/// <param name="func">Callable taking (size_t begin, size_t end)</param>
+	template<typename Func>
+	void ParallelFor(size_t count, size_t grainSize, Func&& func)
+	{
+		if (count == 0)
+			return;
+
+		grainSize = std::max<size_t>(grainSize, 1);
+		if (count > grainSize && WorkerCount() > 1)
+		{
+			using Callable = std::remove_reference_t<Func>;
+			const Detail::ChunkFunc chunk = [](void* context, size_t begin, size_t end)
+			{
+				(*static_cast<Callable*>(context))(begin, end);
+			};
+
+			if (Detail::Pool().TryRun(count, grainSize, chunk, const_cast<void*>(static_cast<const void*>(std::addressof(func)))))
+				return;
+		}
+
+		func(size_t(0), count);
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_PARALLEL_FOR_H
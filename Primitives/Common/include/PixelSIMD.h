@@ -0,0 +1,69 @@
+#ifndef ULTREALITY_RENDERING_PIXEL_SIMD_H
+#define ULTREALITY_RENDERING_PIXEL_SIMD_H
+
+#include <stddef.h>
+#include <algorithm>
+#include <cmath>
+
+#include <VectorTypes.h>
+
+#include <RenderingSIMD.h>
+
+namespace UltReality::Rendering::SIMD
+{
+	/// <summary>
+	/// One RGBA pixel in a SIMD register, or 4 floats on targets without SSE2. Used by the CPU reference image passes
+	/// </summary>
+	struct Pixel
+	{
+#if defined(ULTREALITY_RENDERING_SSE2)
+		__m128 v;
+
+		static Pixel Load(const Math::Float4& p) noexcept { return Pixel{ _mm_loadu_ps(&p.x) }; }
+		static Pixel Splat(float s) noexcept { return Pixel{ _mm_set1_ps(s) }; }
+		void Store(Math::Float4& p) const noexcept { _mm_storeu_ps(&p.x, v); }
+		friend Pixel operator+(Pixel a, Pixel b) noexcept { return Pixel{ _mm_add_ps(a.v, b.v) }; }
+		friend Pixel operator-(Pixel a, Pixel b) noexcept { return Pixel{ _mm_sub_ps(a.v, b.v) }; }
+		friend Pixel operator*(Pixel a, Pixel b) noexcept { return Pixel{ _mm_mul_ps(a.v, b.v) }; }
+		friend Pixel Min(Pixel a, Pixel b) noexcept { return Pixel{ _mm_min_ps(a.v, b.v) }; }
+		friend Pixel Max(Pixel a, Pixel b) noexcept { return Pixel{ _mm_max_ps(a.v, b.v) }; }
+#else
+		float v[4];
+
+		static Pixel Load(const Math::Float4& p) noexcept { return Pixel{ { p.x, p.y, p.z, p.w } }; }
+		static Pixel Splat(float s) noexcept { return Pixel{ { s, s, s, s } }; }
+		void Store(Math::Float4& p) const noexcept { p = Math::Float4{ v[0], v[1], v[2], v[3] }; }
+		friend Pixel operator+(Pixel a, Pixel b) noexcept { return Pixel{ { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+		friend Pixel operator-(Pixel a, Pixel b) noexcept { return Pixel{ { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+		friend Pixel operator*(Pixel a, Pixel b) noexcept { return Pixel{ { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+		friend Pixel Min(Pixel a, Pixel b) noexcept { return Pixel{ { std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3]) } }; }
+		friend Pixel Max(Pixel a, Pixel b) noexcept { return Pixel{ { std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3]) } }; }
+#endif
+
+		friend Pixel Lerp(Pixel a, Pixel b, float t) noexcept { return a + (b - a) * Splat(t); }
+	};
+
+	/// <summary>
+	/// Bilinearly sample a row major image with clamp to edge addressing
+	/// </summary>
+	/// <param name="x">Horizontal position in pixels, pixel centers at integers</param>
+	/// <param name="y">Vertical position in pixels, pixel centers at integers</param>
+	inline Pixel SampleBilinear(const Math::Float4* image, int width, int height, float x, float y) noexcept
+	{
+		const float fx = std::floor(x);
+		const float fy = std::floor(y);
+		const float tx = x - fx;
+		const float ty = y - fy;
+		const int x0 = std::clamp(static_cast<int>(fx), 0, width - 1);
+		const int y0 = std::clamp(static_cast<int>(fy), 0, height - 1);
+		const int x1 = std::clamp(static_cast<int>(fx) + 1, 0, width - 1);
+		const int y1 = std::clamp(static_cast<int>(fy) + 1, 0, height - 1);
+
+		const Pixel top = Lerp(Pixel::Load(image[size_t(y0) * width + x0]), Pixel::Load(image[size_t(y0) * width + x1]), tx);
+		const Pixel bottom = Lerp(Pixel::Load(image[size_t(y1) * width + x0]), Pixel::Load(image[size_t(y1) * width + x1]), tx);
+
+		return Lerp(top, bottom, ty);
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_PIXEL_SIMD_H
@@ -0,0 +1,17 @@
+#ifndef ULTREALITY_RENDERING_SIMD_H
+#define ULTREALITY_RENDERING_SIMD_H
+
+// Selects the SIMD instruction set used by the CPU side rendering routines. Every routine that uses these
+// intrinsics must also provide a scalar path so targets without SSE2 (ARM toolchains) still build
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ULTREALITY_RENDERING_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+	#define ULTREALITY_RENDERING_F16C
+	#include <immintrin.h>
+#endif
+
+#endif // !ULTREALITY_RENDERING_SIMD_H
@@ -0,0 +1,90 @@
+#ifndef ULTREALITY_RENDERING_RESOURCE_REBUILDER_H
+#define ULTREALITY_RENDERING_RESOURCE_REBUILDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Bit mask of resource groups, one bit per group
+	/// </summary>
+	using RebuildMask = uint32_t;
+
+	/// <summary>
+	/// Rebuilds invalidated resource groups on a background thread so changing settings does not stall the frame.
+	/// Invalidating a group that is still pending coalesces into a single rebuild. Invalidating a group while it is being built queues one more
+	/// rebuild after the current one, and the group is only reported once that rebuild finishes. The renderer keeps using the old
+	/// resources until <see cref="Poll"/> reports the group as rebuilt, then swaps them in on its own thread
+	/// </summary>
+	class ResourceRebuilder
+	{
+	protected:
+		static constexpr size_t MaxGroups = 32;
+
+		std::array<std::function<void()>, MaxGroups> m_builders;
+		RebuildMask m_registered = 0;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_idle;
+		RebuildMask m_pending = 0;		// Invalidated and not started yet
+		RebuildMask m_building = 0;		// Taken by the worker
+		RebuildMask m_completed = 0;	// Rebuilt since the last Poll and not invalidated again
+		std::exception_ptr m_error;
+		bool m_stop = false;
+		std::thread m_worker;			// Started by the first invalidation
+
+		void Run();
+
+	public:
+		ResourceRebuilder() = default;
+		ResourceRebuilder(const ResourceRebuilder&) = delete;
+		ResourceRebuilder& operator=(const ResourceRebuilder&) = delete;
+
+		/// <summary>
+		/// Wait for the running rebuild and stop the worker. Pending groups are dropped
+		/// </summary>
+		~ResourceRebuilder();
+
+		/// <summary>
+		/// Register the function that rebuilds a resource group. Builders run on the worker thread in ascending bit order,
+		/// so a group may depend on the groups with lower bits. Register every group before the first <see cref="Invalidate"/>
+		/// </summary>
+		/// <param name="group">Mask with the single bit of the group</param>
+		/// <param name="builder">Creates the group's new resources. Must not touch the resources the renderer is currently using</param>
+		/// <exception cref="std.invalid_argument">Thrown if group does not have exactly one bit set</exception>
+		void Register(RebuildMask group, std::function<void()> builder);
+
+		/// <summary>
+		/// Schedule groups for rebuild. Bits without a registered builder are ignored
+		/// </summary>
+		void Invalidate(RebuildMask groups);
+
+		/// <summary>
+		/// Collect the groups rebuilt since the last call. Call once per frame on the render thread before using the resources
+		/// </summary>
+		/// <returns>Groups whose new resources are ready to swap in</returns>
+		/// <exception>Rethrows the first exception thrown by a builder</exception>
+		RebuildMask Poll();
+
+		/// <summary>
+		/// Check if any of the groups are still waiting for or in a rebuild
+		/// </summary>
+		bool IsPending(RebuildMask groups) const;
+
+		/// <summary>
+		/// Block until every invalidated group has been rebuilt, e.g. before a device reset
+		/// </summary>
+		/// <exception>Rethrows the first exception thrown by a builder</exception>
+		void Wait();
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_RESOURCE_REBUILDER_H
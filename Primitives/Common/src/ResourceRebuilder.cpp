@@ -0,0 +1,123 @@
+#include <ResourceRebuilder.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace UltReality::Rendering
+{
+	ResourceRebuilder::~ResourceRebuilder()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+
+		if (m_worker.joinable())
+			m_worker.join();
+	}
+
+	void ResourceRebuilder::Register(RebuildMask group, std::function<void()> builder)
+	{
+		if (group == 0 || (group & (group - 1)) != 0)
+			throw std::invalid_argument("Resource group must have exactly one bit set");
+
+		size_t bit = 0;
+		while (!(group & (RebuildMask(1) << bit)))
+			bit++;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_builders[bit] = std::move(builder);
+		m_registered |= group;
+	}
+
+	void ResourceRebuilder::Invalidate(RebuildMask groups)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			groups &= m_registered;
+			if (!groups)
+				return;
+
+			m_pending |= groups;
+			m_completed &= ~groups;
+
+			if (!m_worker.joinable())
+				m_worker = std::thread(&ResourceRebuilder::Run, this);
+		}
+		m_wake.notify_one();
+	}
+
+	RebuildMask ResourceRebuilder::Poll()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_error)
+			std::rethrow_exception(std::exchange(m_error, nullptr));
+
+		return std::exchange(m_completed, 0);
+	}
+
+	bool ResourceRebuilder::IsPending(RebuildMask groups) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return ((m_pending | m_building) & groups) != 0;
+	}
+
+	void ResourceRebuilder::Wait()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idle.wait(lock, [this] { return !m_pending && !m_building; });
+
+		if (m_error)
+			std::rethrow_exception(std::exchange(m_error, nullptr));
+	}
+
+	void ResourceRebuilder::Run()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true)
+		{
+			m_wake.wait(lock, [this] { return m_stop || m_pending; });
+			if (m_stop)
+				break;
+
+			// Take everything invalidated so far, invalidating one of these groups while it builds queues a second rebuild
+			m_building = std::exchange(m_pending, 0);
+
+			for (size_t bit = 0; bit < MaxGroups && !m_stop; bit++)
+			{
+				const RebuildMask group = RebuildMask(1) << bit;
+				if (!(m_building & group))
+					continue;
+
+				lock.unlock();
+				std::exception_ptr error;
+				try
+				{
+					m_builders[bit]();
+				}
+				catch (...)
+				{
+					error = std::current_exception();
+				}
+				lock.lock();
+
+				m_building &= ~group;
+				if (error)
+				{
+					if (!m_error)
+						m_error = error;
+				}
+				else if (!(m_pending & group))
+					m_completed |= group;
+			}
+
+			m_building = 0;
+			if (!m_pending)
+				m_idle.notify_all();
+		}
+
+		m_pending = m_building = 0;
+		m_idle.notify_all();
+	}
+}
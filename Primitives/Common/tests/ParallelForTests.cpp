@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <ParallelFor.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace UltReality::Rendering;
+
+namespace
+{
+	constexpr size_t PoolThreads = 4;
+
+	/// <summary>
+	/// Functor owning its coverage counters on the heap, so a worker running it after the call returned touches freed memory
+	/// </summary>
+	struct CoverageFunc
+	{
+		uint32_t id;
+		std::unique_ptr<std::atomic<uint32_t>[]> hits;
+		std::atomic<uint32_t>* foreignCalls;
+
+		CoverageFunc(uint32_t id, size_t count, std::atomic<uint32_t>* foreignCalls) : id(id), hits(new std::atomic<uint32_t>[count]), foreignCalls(foreignCalls)
+		{
+			for (size_t i = 0; i < count; i++)
+				hits[i] = 0;
+		}
+
+		void operator()(size_t begin, size_t end, uint32_t expectedId) const
+		{
+			if (id != expectedId)
+				foreignCalls->fetch_add(1);
+			for (size_t i = begin; i < end; i++)
+				hits[i].fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	struct Call
+	{
+		CoverageFunc* func;
+		uint32_t id;
+	};
+
+	void RunChunk(void* context, size_t begin, size_t end)
+	{
+		const Call* call = static_cast<const Call*>(context);
+		(*call->func)(begin, end, call->id);
+	}
+
+	// Submit one range to the pool the way ParallelFor does and check it was covered exactly once by its own functor
+	void RunAndCheck(Parallel::Detail::WorkerPool& pool, uint32_t id, size_t count, size_t grainSize, std::atomic<uint32_t>& foreignCalls, std::atomic<uint32_t>& coverageErrors)
+	{
+		CoverageFunc func(id, count, &foreignCalls);
+		const Call call{ &func, id };
+		if (!pool.TryRun(count, grainSize, RunChunk, const_cast<Call*>(&call)))
+			RunChunk(const_cast<Call*>(&call), 0, count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (func.hits[i].load() != 1)
+				coverageErrors.fetch_add(1);
+		}
+	}
+}
+
+TEST(ParallelFor, CoversRangeExactlyOnce)
+{
+	for (const size_t count : { size_t(1), size_t(7), size_t(64), size_t(1000) })
+	{
+		for (const size_t grainSize : { size_t(0), size_t(1), size_t(3), size_t(64), size_t(5000) })
+		{
+			std::vector<std::atomic<uint32_t>> hits(count);
+			Parallel::ParallelFor(count, grainSize, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+					hits[i].fetch_add(1, std::memory_order_relaxed);
+			});
+
+			for (size_t i = 0; i < count; i++)
+				ASSERT_EQ(hits[i].load(), 1u) << "count " << count << " grain " << grainSize << " item " << i;
+		}
+	}
+}
+
+TEST(ParallelFor, EmptyRangeDoesNotCall)
+{
+	bool called = false;
+	Parallel::ParallelFor(0, 16, [&](size_t, size_t) { called = true; });
+	EXPECT_FALSE(called);
+}
+
+TEST(ParallelFor, NestedCallsComplete)
+{
+	std::atomic<size_t> total{ 0 };
+	Parallel::ParallelFor(16, 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			Parallel::ParallelFor(32, 4, [&](size_t innerBegin, size_t innerEnd) { total += innerEnd - innerBegin; });
+	});
+
+	EXPECT_EQ(total.load(), 16u * 32u);
+}
+
+// Back to back ranges must each run only with their own functor, even when a worker wakes late for an earlier range
+TEST(WorkerPool, SequentialRangesUseTheirOwnFunctor)
+{
+	Parallel::Detail::WorkerPool pool(PoolThreads);
+	std::atomic<uint32_t> foreignCalls{ 0 };
+	std::atomic<uint32_t> coverageErrors{ 0 };
+
+	for (uint32_t id = 0; id < 20000; id++)
+		RunAndCheck(pool, id, 1 + id % 37, 1 + id % 5, foreignCalls, coverageErrors);
+
+	EXPECT_EQ(foreignCalls.load(), 0u);
+	EXPECT_EQ(coverageErrors.load(), 0u);
+}
+
+// Several threads submitting at once, the ones that find the pool busy run inline
+TEST(WorkerPool, ConcurrentSubmittersUseTheirOwnFunctor)
+{
+	Parallel::Detail::WorkerPool pool(PoolThreads);
+	std::atomic<uint32_t> foreignCalls{ 0 };
+	std::atomic<uint32_t> coverageErrors{ 0 };
+
+	std::vector<std::thread> submitters;
+	for (uint32_t thread = 0; thread < 4; thread++)
+	{
+		submitters.emplace_back([&, thread]
+		{
+			for (uint32_t i = 0; i < 5000; i++)
+				RunAndCheck(pool, thread * 100000 + i, 1 + i % 53, 1 + i % 7, foreignCalls, coverageErrors);
+		});
+	}
+	for (std::thread& submitter : submitters)
+		submitter.join();
+
+	EXPECT_EQ(foreignCalls.load(), 0u);
+	EXPECT_EQ(coverageErrors.load(), 0u);
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <ResourceRebuilder.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace UltReality::Rendering;
+
+namespace
+{
+	constexpr RebuildMask GroupA = 1 << 0;
+	constexpr RebuildMask GroupB = 1 << 1;
+	constexpr RebuildMask GroupC = 1 << 2;
+
+	/// <summary>
+	/// Holds a builder inside its call until the test opens it, so the test knows exactly which rebuild is running
+	/// </summary>
+	class Gate
+	{
+	protected:
+		std::mutex m_mutex;
+		std::condition_variable m_changed;
+		size_t m_entered = 0;
+		size_t m_opened = 0;
+
+	public:
+		// Called by the builder
+		void Pass()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			const size_t ticket = m_entered++;
+			m_changed.notify_all();
+			m_changed.wait(lock, [&] { return m_opened > ticket; });
+		}
+
+		void WaitEntered(size_t count)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_changed.wait(lock, [&] { return m_entered >= count; });
+		}
+
+		void Open()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_opened++;
+			m_changed.notify_all();
+		}
+	};
+}
+
+TEST(ResourceRebuilder, RegisterRejectsMasksWithoutOneBit)
+{
+	ResourceRebuilder rebuilder;
+	EXPECT_THROW(rebuilder.Register(0, [] {}), std::invalid_argument);
+	EXPECT_THROW(rebuilder.Register(GroupA | GroupB, [] {}), std::invalid_argument);
+}
+
+TEST(ResourceRebuilder, UnregisteredGroupsAreIgnored)
+{
+	std::atomic<int> builds{ 0 };
+	ResourceRebuilder rebuilder;
+	rebuilder.Register(GroupA, [&] { builds++; });
+
+	rebuilder.Invalidate(GroupB | GroupC);
+	EXPECT_FALSE(rebuilder.IsPending(GroupB | GroupC));
+	rebuilder.Wait();
+	EXPECT_EQ(rebuilder.Poll(), 0u);
+	EXPECT_EQ(builds, 0);
+}
+
+TEST(ResourceRebuilder, BuildsGroupsInBitOrder)
+{
+	std::mutex orderMutex;
+	std::vector<RebuildMask> order;
+	ResourceRebuilder rebuilder;
+	for (RebuildMask group : { GroupC, GroupA, GroupB })
+		rebuilder.Register(group, [&, group] { std::lock_guard<std::mutex> lock(orderMutex); order.push_back(group); });
+
+	rebuilder.Invalidate(GroupC | GroupB | GroupA);
+	rebuilder.Wait();
+
+	EXPECT_EQ(order, (std::vector<RebuildMask>{ GroupA, GroupB, GroupC }));
+	EXPECT_EQ(rebuilder.Poll(), GroupA | GroupB | GroupC);
+	EXPECT_EQ(rebuilder.Poll(), 0u);
+}
+
+TEST(ResourceRebuilder, PendingInvalidationsCoalesce)
+{
+	Gate gate;
+	std::atomic<int> buildsB{ 0 };
+	ResourceRebuilder rebuilder;
+	rebuilder.Register(GroupA, [&] { gate.Pass(); });
+	rebuilder.Register(GroupB, [&] { buildsB++; });
+
+	// Keep the worker busy with A so B stays pending while it is invalidated again
+	rebuilder.Invalidate(GroupA);
+	gate.WaitEntered(1);
+	for (int i = 0; i < 5; i++)
+		rebuilder.Invalidate(GroupB);
+	EXPECT_TRUE(rebuilder.IsPending(GroupB));
+
+	gate.Open();
+	rebuilder.Wait();
+
+	EXPECT_EQ(buildsB, 1);
+	EXPECT_EQ(rebuilder.Poll(), GroupA | GroupB);
+}
+
+TEST(ResourceRebuilder, InvalidatingDuringBuildQueuesAnotherBuild)
+{
+	Gate gate;
+	std::atomic<int> builds{ 0 };
+	ResourceRebuilder rebuilder;
+	rebuilder.Register(GroupA, [&] { gate.Pass(); builds++; });
+
+	rebuilder.Invalidate(GroupA);
+	gate.WaitEntered(1);
+	rebuilder.Invalidate(GroupA);
+
+	// The first build finishes, but its resources are already stale so A is not reported
+	gate.Open();
+	gate.WaitEntered(2);
+	EXPECT_EQ(builds, 1);
+	EXPECT_EQ(rebuilder.Poll(), 0u);
+	EXPECT_TRUE(rebuilder.IsPending(GroupA));
+
+	gate.Open();
+	rebuilder.Wait();
+	EXPECT_EQ(builds, 2);
+	EXPECT_FALSE(rebuilder.IsPending(GroupA));
+	EXPECT_EQ(rebuilder.Poll(), GroupA);
+}
+
+TEST(ResourceRebuilder, BuilderExceptionReachesWait)
+{
+	std::atomic<int> buildsB{ 0 };
+	ResourceRebuilder rebuilder;
+	rebuilder.Register(GroupA, [] { throw std::runtime_error("device lost"); });
+	rebuilder.Register(GroupB, [&] { buildsB++; });
+
+	rebuilder.Invalidate(GroupA | GroupB);
+	EXPECT_THROW(rebuilder.Wait(), std::runtime_error);
+
+	// The failure is reported once, the other groups of the batch still build
+	EXPECT_NO_THROW(rebuilder.Wait());
+	EXPECT_EQ(buildsB, 1);
+	EXPECT_EQ(rebuilder.Poll(), GroupB);
+}
+
+TEST(ResourceRebuilder, BuilderExceptionReachesPoll)
+{
+	ResourceRebuilder rebuilder;
+	rebuilder.Register(GroupA, [] { throw std::runtime_error("out of memory"); });
+
+	rebuilder.Invalidate(GroupA);
+	while (rebuilder.IsPending(GroupA))
+		std::this_thread::yield();
+
+	EXPECT_THROW(rebuilder.Poll(), std::runtime_error);
+	EXPECT_EQ(rebuilder.Poll(), 0u);
+}
+
+TEST(ResourceRebuilder, DestructorFinishesRunningBuildAndDropsPending)
+{
+	Gate gate;
+	std::atomic<int> buildsA{ 0 };
+	std::atomic<int> buildsB{ 0 };
+	auto rebuilder = std::make_unique<ResourceRebuilder>();
+	rebuilder->Register(GroupA, [&] { gate.Pass(); buildsA++; });
+	rebuilder->Register(GroupB, [&] { buildsB++; });
+
+	rebuilder->Invalidate(GroupA);
+	gate.WaitEntered(1);
+	rebuilder->Invalidate(GroupB);
+
+	// Open the gate only once the destructor is waiting on the worker
+	std::thread opener([&] { std::this_thread::sleep_for(std::chrono::milliseconds(20)); gate.Open(); });
+	rebuilder.reset();
+	opener.join();
+
+	EXPECT_EQ(buildsA, 1);
+	EXPECT_EQ(buildsB, 0);
+}
@@ -0,0 +1,43 @@
+#ifndef ULTREALITY_RENDERING_FRUSTUM_H
+#define ULTREALITY_RENDERING_FRUSTUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// View frustum stored as 6 normalized planes (xyz = inward facing normal, w = distance) in the order left, right, bottom, top, near, far
+	/// </summary>
+	struct Frustum
+	{
+		Math::Float4 planes[6];
+
+		/// <summary>
+		/// Extract the frustum planes from a row-vector view-projection matrix with a [0, 1] clip space depth range
+		/// </summary>
+		/// <param name="viewProj">Combined view-projection matrix</param>
+		/// <returns>Frustum in the space the matrix transforms from (world space for a view-projection matrix)</returns>
+		static Frustum FromViewProjection(const Math::Float4x4& viewProj) noexcept;
+
+		/// <summary>
+		/// Test if a sphere is at least partially inside the frustum
+		/// </summary>
+		bool IntersectsSphere(const Math::Float3& center, float radius) const noexcept;
+
+		/// <summary>
+		/// Batch test spheres stored as SoA against the frustum
+		/// </summary>
+		/// <param name="x">Sphere center x components</param>
+		/// <param name="y">Sphere center y components</param>
+		/// <param name="z">Sphere center z components</param>
+		/// <param name="radius">Sphere radii</param>
+		/// <param name="count">Number of spheres</param>
+		/// <param name="visible">Output, set to 1 for spheres intersecting the frustum and 0 otherwise</param>
+		void CullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count, uint8_t* visible) const noexcept;
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_FRUSTUM_H
@@ -0,0 +1,123 @@
+#ifndef ULTREALITY_RENDERING_OCCLUSION_CULLER_H
+#define ULTREALITY_RENDERING_OCCLUSION_CULLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Software hierarchical-Z occlusion culling. A small set of occluder meshes is rasterized into a low resolution depth buffer on the CPU,
+	/// reduced into a max depth pyramid, and object bounds are tested against it so hidden objects are rejected before draw submission.
+	/// Runs without a GPU. Expects a row-vector view-projection matrix with a [0, 1] clip space depth range
+	/// </summary>
+	class OcclusionCuller
+	{
+	public:
+		static constexpr uint16_t DefaultWidth = 256;
+		static constexpr uint16_t DefaultHeight = 128;
+
+	protected:
+		struct ScreenTriangle
+		{
+			float x[3];
+			float y[3];
+			float z[3];
+			int32_t minX, minY, maxX, maxY; // Pixel bounds, clamped to the depth buffer
+		};
+
+		struct HiZLevel
+		{
+			uint16_t width;
+			uint16_t height;
+			std::vector<float> depth;
+		};
+
+		uint16_t m_width;
+		uint16_t m_height;
+		Math::Float4x4 m_viewProj;
+		std::vector<ScreenTriangle> m_triangles;
+		std::vector<HiZLevel> m_levels; // Level 0 is the rasterized depth buffer
+
+	public:
+		/// <summary>
+		/// Create an occlusion culler
+		/// </summary>
+		/// <param name="width">Width of the occlusion depth buffer in pixels</param>
+		/// <param name="height">Height of the occlusion depth buffer in pixels</param>
+		/// <exception cref="std.invalid_argument">Thrown if either dimension is 0</exception>
+		OcclusionCuller(uint16_t width = DefaultWidth, uint16_t height = DefaultHeight);
+
+		/// <summary>
+		/// Start a new frame. Discards the previous frame's occluders
+		/// </summary>
+		/// <param name="viewProj">Camera view-projection matrix of the frame</param>
+		void BeginFrame(const Math::Float4x4& viewProj);
+
+		/// <summary>
+		/// Queue an occluder mesh for rasterization. Occluders should be large, simple and fully opaque (walls, terrain, building shells)
+		/// </summary>
+		/// <param name="positions">Pointer to the position of the first vertex</param>
+		/// <param name="vertexCount">Number of vertices</param>
+		/// <param name="positionStride">Number of bytes between consecutive positions</param>
+		/// <param name="indices">Triangle list indices</param>
+		/// <param name="indexCount">Number of indices</param>
+		/// <param name="world">Object to world matrix of the occluder</param>
+		void AddOccluder(const Math::Float3* positions, size_t vertexCount, size_t positionStride, const uint32_t* indices, size_t indexCount, const Math::Float4x4& world);
+
+		/// <summary>
+		/// Rasterize the queued occluders in parallel and build the Hi-Z pyramid. Must be called before testing bounds
+		/// </summary>
+		void Finalize();
+
+		/// <summary>
+		/// Test if an axis aligned box may be visible
+		/// </summary>
+		/// <param name="center">World space box center</param>
+		/// <param name="extent">Half size of the box on each axis</param>
+		/// <returns>False only if the box is completely hidden by the occluders</returns>
+		bool IsVisible(const Math::Float3& center, const Math::Float3& extent) const noexcept;
+
+		/// <summary>
+		/// Test axis aligned boxes stored as SoA in parallel
+		/// </summary>
+		/// <param name="centerX">Box center x components</param>
+		/// <param name="centerY">Box center y components</param>
+		/// <param name="centerZ">Box center z components</param>
+		/// <param name="extentX">Box half size x components</param>
+		/// <param name="extentY">Box half size y components</param>
+		/// <param name="extentZ">Box half size z components</param>
+		/// <param name="count">Number of boxes</param>
+		/// <param name="visible">Output, set to 1 for boxes that may be visible and 0 for hidden boxes</param>
+		void TestBounds(const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ, size_t count, uint8_t* visible) const;
+
+		/// <summary>
+		/// Get the number of triangles queued this frame after near plane clipping
+		/// </summary>
+		size_t GetTriangleCount() const noexcept
+		{
+			return m_triangles.size();
+		}
+
+		/// <summary>
+		/// Get the number of levels in the Hi-Z pyramid
+		/// </summary>
+		size_t GetLevelCount() const noexcept
+		{
+			return m_levels.size();
+		}
+
+		/// <summary>
+		/// Get the max depth values of a pyramid level, row major. Useful for debug visualization
+		/// </summary>
+		const std::vector<float>& GetDepth(size_t level = 0) const noexcept
+		{
+			return m_levels[level].depth;
+		}
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_OCCLUSION_CULLER_H
@@ -0,0 +1,85 @@
+#include <Frustum.h>
+#include <RenderingSIMD.h>
+
+#include <cmath>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		inline Math::Float4 NormalizePlane(float a, float b, float c, float d) noexcept
+		{
+			const float length = std::sqrt(a * a + b * b + c * c);
+			const float invLength = length > 0.0f ? 1.0f / length : 0.0f;
+
+			return Math::Float4{ a * invLength, b * invLength, c * invLength, d * invLength };
+		}
+	}
+
+	Frustum Frustum::FromViewProjection(const Math::Float4x4& viewProj) noexcept
+	{
+		const auto& m = viewProj.m;
+
+		// Gribb/Hartmann extraction on the matrix columns. Row-vector convention, clip space z in [0, w]
+		Frustum frustum;
+		frustum.planes[0] = NormalizePlane(m[0][3] + m[0][0], m[1][3] + m[1][0], m[2][3] + m[2][0], m[3][3] + m[3][0]);
+		frustum.planes[1] = NormalizePlane(m[0][3] - m[0][0], m[1][3] - m[1][0], m[2][3] - m[2][0], m[3][3] - m[3][0]);
+		frustum.planes[2] = NormalizePlane(m[0][3] + m[0][1], m[1][3] + m[1][1], m[2][3] + m[2][1], m[3][3] + m[3][1]);
+		frustum.planes[3] = NormalizePlane(m[0][3] - m[0][1], m[1][3] - m[1][1], m[2][3] - m[2][1], m[3][3] - m[3][1]);
+		frustum.planes[4] = NormalizePlane(m[0][2], m[1][2], m[2][2], m[3][2]);
+		frustum.planes[5] = NormalizePlane(m[0][3] - m[0][2], m[1][3] - m[1][2], m[2][3] - m[2][2], m[3][3] - m[3][2]);
+
+		return frustum;
+	}
+
+	bool Frustum::IntersectsSphere(const Math::Float3& center, float radius) const noexcept
+	{
+		for (const Math::Float4& plane : planes)
+		{
+			if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+				return false;
+		}
+
+		return true;
+	}
+
+	void Frustum::CullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count, uint8_t* visible) const noexcept
+	{
+		size_t i = 0;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+		__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (size_t p = 0; p < 6; p++)
+		{
+			planeX[p] = _mm_set1_ps(planes[p].x);
+			planeY[p] = _mm_set1_ps(planes[p].y);
+			planeZ[p] = _mm_set1_ps(planes[p].z);
+			planeW[p] = _mm_set1_ps(planes[p].w);
+		}
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 cx = _mm_loadu_ps(x + i);
+			const __m128 cy = _mm_loadu_ps(y + i);
+			const __m128 cz = _mm_loadu_ps(z + i);
+			const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (size_t p = 0; p < 6; p++)
+			{
+				const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, planeX[p]), _mm_mul_ps(cy, planeY[p])), _mm_add_ps(_mm_mul_ps(cz, planeZ[p]), planeW[p]));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+			}
+
+			const int mask = _mm_movemask_ps(inside);
+			visible[i + 0] = static_cast<uint8_t>(mask & 1);
+			visible[i + 1] = static_cast<uint8_t>((mask >> 1) & 1);
+			visible[i + 2] = static_cast<uint8_t>((mask >> 2) & 1);
+			visible[i + 3] = static_cast<uint8_t>((mask >> 3) & 1);
+		}
+#endif
+
+		for (; i < count; i++)
+			visible[i] = IntersectsSphere(Math::Float3{ x[i], y[i], z[i] }, radius[i]) ? 1 : 0;
+	}
+}
@@ -0,0 +1,374 @@
+#include <OcclusionCuller.h>
+#include <ParallelFor.h>
+#include <RenderingSIMD.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		// Rows of the depth buffer rasterized per task. Each task owns its rows so no synchronization is needed
+		constexpr int BandHeight = 8;
+		constexpr size_t TestGrainSize = 512;
+		constexpr float MinimumW = 1e-5f;
+		constexpr float MinimumArea = 1e-8f;
+
+		struct ClipVertex
+		{
+			float x, y, z, w;
+		};
+
+		inline ClipVertex Transform(const Math::Float4x4& m, float x, float y, float z) noexcept
+		{
+			return ClipVertex{
+				x * m.m[0][0] + y * m.m[1][0] + z * m.m[2][0] + m.m[3][0],
+				x * m.m[0][1] + y * m.m[1][1] + z * m.m[2][1] + m.m[3][1],
+				x * m.m[0][2] + y * m.m[1][2] + z * m.m[2][2] + m.m[3][2],
+				x * m.m[0][3] + y * m.m[1][3] + z * m.m[2][3] + m.m[3][3]
+			};
+		}
+
+		inline Math::Float4x4 Multiply(const Math::Float4x4& a, const Math::Float4x4& b) noexcept
+		{
+			Math::Float4x4 result;
+			for (size_t r = 0; r < 4; r++)
+			{
+				for (size_t c = 0; c < 4; c++)
+					result.m[r][c] = a.m[r][0] * b.m[0][c] + a.m[r][1] * b.m[1][c] + a.m[r][2] * b.m[2][c] + a.m[r][3] * b.m[3][c];
+			}
+
+			return result;
+		}
+
+		inline ClipVertex Lerp(const ClipVertex& a, const ClipVertex& b, float t) noexcept
+		{
+			return ClipVertex{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t };
+		}
+
+		/// Clip a triangle against the near plane (z >= 0). Produces 0, 3 or 4 vertices
+		size_t ClipNear(const ClipVertex (&in)[3], ClipVertex (&out)[4]) noexcept
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < 3; i++)
+			{
+				const ClipVertex& a = in[i];
+				const ClipVertex& b = in[(i + 1) % 3];
+				const bool aInside = a.z >= 0.0f && a.w > MinimumW;
+				const bool bInside = b.z >= 0.0f && b.w > MinimumW;
+
+				if (aInside)
+					out[count++] = a;
+				if (aInside != bInside)
+				{
+					const float t = a.z / (a.z - b.z);
+					ClipVertex clipped = Lerp(a, b, t);
+					clipped.w = std::max(clipped.w, MinimumW);
+					out[count++] = clipped;
+				}
+			}
+
+			return count;
+		}
+	}
+
+	OcclusionCuller::OcclusionCuller(uint16_t width, uint16_t height) : m_width(width), m_height(height), m_viewProj(Math::Float4x4::Identity)
+	{
+		if (width == 0 || height == 0)
+			throw std::invalid_argument("Occlusion buffer dimensions must be greater than 0");
+
+		// Max depth pyramid down to a single texel. Texel i of level n covers texels [2i, 2i + 1] of level n - 1
+		uint16_t levelWidth = width;
+		uint16_t levelHeight = height;
+		while (true)
+		{
+			m_levels.push_back(HiZLevel{ levelWidth, levelHeight, std::vector<float>(size_t(levelWidth) * levelHeight, 1.0f) });
+			if (levelWidth == 1 && levelHeight == 1)
+				break;
+
+			levelWidth = static_cast<uint16_t>((levelWidth + 1) / 2);
+			levelHeight = static_cast<uint16_t>((levelHeight + 1) / 2);
+		}
+	}
+
+	void OcclusionCuller::BeginFrame(const Math::Float4x4& viewProj)
+	{
+		m_viewProj = viewProj;
+		m_triangles.clear();
+	}
+
+	void OcclusionCuller::AddOccluder(const Math::Float3* positions, size_t vertexCount, size_t positionStride, const uint32_t* indices, size_t indexCount, const Math::Float4x4& world)
+	{
+		const Math::Float4x4 worldViewProj = Multiply(world, m_viewProj);
+
+		std::vector<ClipVertex> clip(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			const Math::Float3& p = *reinterpret_cast<const Math::Float3*>(reinterpret_cast<const uint8_t*>(positions) + positionStride * i);
+			clip[i] = Transform(worldViewProj, p.x, p.y, p.z);
+		}
+
+		const float halfWidth = 0.5f * m_width;
+		const float halfHeight = 0.5f * m_height;
+
+		for (size_t t = 0; t + 2 < indexCount; t += 3)
+		{
+			if (indices[t] >= vertexCount || indices[t + 1] >= vertexCount || indices[t + 2] >= vertexCount)
+				continue;
+
+			const ClipVertex in[3] = { clip[indices[t]], clip[indices[t + 1]], clip[indices[t + 2]] };
+			ClipVertex polygon[4];
+			const size_t polygonCount = ClipNear(in, polygon);
+
+			// Project to pixel space, y down
+			float sx[4], sy[4], sz[4];
+			for (size_t i = 0; i < polygonCount; i++)
+			{
+				const float invW = 1.0f / polygon[i].w;
+				sx[i] = (polygon[i].x * invW + 1.0f) * halfWidth;
+				sy[i] = (1.0f - polygon[i].y * invW) * halfHeight;
+				sz[i] = std::min(polygon[i].z * invW, 1.0f);
+			}
+
+			// Fan triangulate the clipped polygon
+			for (size_t i = 2; i < polygonCount; i++)
+			{
+				ScreenTriangle tri{ { sx[0], sx[i - 1], sx[i] }, { sy[0], sy[i - 1], sy[i] }, { sz[0], sz[i - 1], sz[i] }, 0, 0, 0, 0 };
+
+				const float minX = std::min({ tri.x[0], tri.x[1], tri.x[2] });
+				const float maxX = std::max({ tri.x[0], tri.x[1], tri.x[2] });
+				const float minY = std::min({ tri.y[0], tri.y[1], tri.y[2] });
+				const float maxY = std::max({ tri.y[0], tri.y[1], tri.y[2] });
+				if (maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height)
+					continue;
+
+				tri.minX = static_cast<int32_t>(std::max(std::floor(minX), 0.0f));
+				tri.minY = static_cast<int32_t>(std::max(std::floor(minY), 0.0f));
+				tri.maxX = static_cast<int32_t>(std::min(std::ceil(maxX), static_cast<float>(m_width - 1)));
+				tri.maxY = static_cast<int32_t>(std::min(std::ceil(maxY), static_cast<float>(m_height - 1)));
+
+				m_triangles.push_back(tri);
+			}
+		}
+	}
+
+	void OcclusionCuller::Finalize()
+	{
+		HiZLevel& base = m_levels[0];
+		const int width = m_width;
+		const int height = m_height;
+		const size_t bandCount = (height + BandHeight - 1) / BandHeight;
+
+		Parallel::ParallelFor(bandCount, 1, [&](size_t bandBegin, size_t bandEnd)
+		{
+			for (size_t band = bandBegin; band < bandEnd; band++)
+			{
+				const int rowBegin = static_cast<int>(band) * BandHeight;
+				const int rowEnd = std::min(rowBegin + BandHeight, height);
+				std::fill(base.depth.begin() + size_t(rowBegin) * width, base.depth.begin() + size_t(rowEnd) * width, 1.0f);
+
+				for (const ScreenTriangle& tri : m_triangles)
+				{
+					if (tri.maxY < rowBegin || tri.minY >= rowEnd)
+						continue;
+
+					// Edge functions. Edge i is opposite vertex i, so its value over the area is vertex i's barycentric weight
+					float a[3], b[3], c[3];
+					for (size_t e = 0; e < 3; e++)
+					{
+						const size_t v0 = (e + 1) % 3;
+						const size_t v1 = (e + 2) % 3;
+						a[e] = tri.y[v0] - tri.y[v1];
+						b[e] = tri.x[v1] - tri.x[v0];
+						c[e] = tri.x[v0] * tri.y[v1] - tri.x[v1] * tri.y[v0];
+					}
+
+					float area = a[0] * tri.x[0] + b[0] * tri.y[0] + c[0];
+					if (std::abs(area) < MinimumArea)
+						continue;
+
+					// Occluders are rasterized double sided, flip the edges of back facing triangles
+					if (area < 0.0f)
+					{
+						for (size_t e = 0; e < 3; e++)
+						{
+							a[e] = -a[e];
+							b[e] = -b[e];
+							c[e] = -c[e];
+						}
+						area = -area;
+					}
+
+					const float invArea = 1.0f / area;
+					const float zA = (a[0] * tri.z[0] + a[1] * tri.z[1] + a[2] * tri.z[2]) * invArea;
+					const float zB = (b[0] * tri.z[0] + b[1] * tri.z[1] + b[2] * tri.z[2]) * invArea;
+					const float zC = (c[0] * tri.z[0] + c[1] * tri.z[1] + c[2] * tri.z[2]) * invArea;
+
+					const int yBegin = std::max<int>(tri.minY, rowBegin);
+					const int yEnd = std::min<int>(tri.maxY + 1, rowEnd);
+					for (int y = yBegin; y < yEnd; y++)
+					{
+						const float py = static_cast<float>(y) + 0.5f;
+						float* row = base.depth.data() + size_t(y) * width;
+						int x = tri.minX;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+						const __m128 laneOffset = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+						const __m128 zero = _mm_setzero_ps();
+						const __m128 one = _mm_set1_ps(1.0f);
+						const __m128 a0 = _mm_set1_ps(a[0]), a1 = _mm_set1_ps(a[1]), a2 = _mm_set1_ps(a[2]);
+						const __m128 r0 = _mm_set1_ps(b[0] * py + c[0]), r1 = _mm_set1_ps(b[1] * py + c[1]), r2 = _mm_set1_ps(b[2] * py + c[2]);
+						const __m128 zAV = _mm_set1_ps(zA);
+						const __m128 zRow = _mm_set1_ps(zB * py + zC);
+
+						for (; x + 3 <= tri.maxX; x += 4)
+						{
+							const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset);
+							__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), r0), zero);
+							inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), r1), zero));
+							inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), r2), zero));
+							if (_mm_movemask_ps(inside) == 0)
+								continue;
+
+							const __m128 depth = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(zAV, px), zRow), zero), one);
+							const __m128 current = _mm_loadu_ps(row + x);
+							const __m128 nearest = _mm_min_ps(current, depth);
+							_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+						}
+#endif
+
+						for (; x <= tri.maxX; x++)
+						{
+							const float px = static_cast<float>(x) + 0.5f;
+							if (a[0] * px + b[0] * py + c[0] < 0.0f || a[1] * px + b[1] * py + c[1] < 0.0f || a[2] * px + b[2] * py + c[2] < 0.0f)
+								continue;
+
+							const float depth = std::clamp(zA * px + zB * py + zC, 0.0f, 1.0f);
+							row[x] = std::min(row[x], depth);
+						}
+					}
+				}
+			}
+		});
+
+		// Reduce into the max depth pyramid
+		for (size_t level = 1; level < m_levels.size(); level++)
+		{
+			const HiZLevel& source = m_levels[level - 1];
+			HiZLevel& target = m_levels[level];
+
+			Parallel::ParallelFor(target.height, 16, [&](size_t rowBegin, size_t rowEnd)
+			{
+				for (size_t y = rowBegin; y < rowEnd; y++)
+				{
+					const size_t sy0 = y * 2;
+					const size_t sy1 = std::min<size_t>(sy0 + 1, source.height - 1);
+					for (size_t x = 0; x < target.width; x++)
+					{
+						const size_t sx0 = x * 2;
+						const size_t sx1 = std::min<size_t>(sx0 + 1, source.width - 1);
+						target.depth[y * target.width + x] = std::max(
+							std::max(source.depth[sy0 * source.width + sx0], source.depth[sy0 * source.width + sx1]),
+							std::max(source.depth[sy1 * source.width + sx0], source.depth[sy1 * source.width + sx1]));
+					}
+				}
+			});
+		}
+	}
+
+	bool OcclusionCuller::IsVisible(const Math::Float3& center, const Math::Float3& extent) const noexcept
+	{
+		float minX, minY, maxX, maxY, minZ;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+		const __m128 row0 = _mm_set_ps(m_viewProj.m[0][3], m_viewProj.m[0][2], m_viewProj.m[0][1], m_viewProj.m[0][0]);
+		const __m128 row1 = _mm_set_ps(m_viewProj.m[1][3], m_viewProj.m[1][2], m_viewProj.m[1][1], m_viewProj.m[1][0]);
+		const __m128 row2 = _mm_set_ps(m_viewProj.m[2][3], m_viewProj.m[2][2], m_viewProj.m[2][1], m_viewProj.m[2][0]);
+		const __m128 row3 = _mm_set_ps(m_viewProj.m[3][3], m_viewProj.m[3][2], m_viewProj.m[3][1], m_viewProj.m[3][0]);
+
+		// Center and the signed extent along each axis in clip space, corners are center +- each axis term
+		const __m128 clipCenter = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(center.x), row0), _mm_mul_ps(_mm_set1_ps(center.y), row1)), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(center.z), row2), row3));
+		const __m128 axisX = _mm_mul_ps(_mm_set1_ps(extent.x), row0);
+		const __m128 axisY = _mm_mul_ps(_mm_set1_ps(extent.y), row1);
+		const __m128 axisZ = _mm_mul_ps(_mm_set1_ps(extent.z), row2);
+
+		__m128 ndcMin = _mm_set1_ps(3.402823466e+38f);
+		__m128 ndcMax = _mm_set1_ps(-3.402823466e+38f);
+		alignas(16) float clip[4];
+		for (int corner = 0; corner < 8; corner++)
+		{
+			__m128 p = clipCenter;
+			p = (corner & 1) ? _mm_add_ps(p, axisX) : _mm_sub_ps(p, axisX);
+			p = (corner & 2) ? _mm_add_ps(p, axisY) : _mm_sub_ps(p, axisY);
+			p = (corner & 4) ? _mm_add_ps(p, axisZ) : _mm_sub_ps(p, axisZ);
+
+			_mm_store_ps(clip, p);
+			if (clip[3] <= MinimumW || clip[2] < 0.0f)
+				return true; // Crosses the near plane
+
+			const __m128 ndc = _mm_div_ps(p, _mm_set1_ps(clip[3]));
+			ndcMin = _mm_min_ps(ndcMin, ndc);
+			ndcMax = _mm_max_ps(ndcMax, ndc);
+		}
+
+		alignas(16) float lo[4];
+		alignas(16) float hi[4];
+		_mm_store_ps(lo, ndcMin);
+		_mm_store_ps(hi, ndcMax);
+		minX = lo[0]; minY = lo[1]; minZ = lo[2];
+		maxX = hi[0]; maxY = hi[1];
+#else
+		minX = minY = minZ = 3.402823466e+38f;
+		maxX = maxY = -3.402823466e+38f;
+		for (int corner = 0; corner < 8; corner++)
+		{
+			const ClipVertex p = Transform(m_viewProj,
+				center.x + ((corner & 1) ? extent.x : -extent.x),
+				center.y + ((corner & 2) ? extent.y : -extent.y),
+				center.z + ((corner & 4) ? extent.z : -extent.z));
+			if (p.w <= MinimumW || p.z < 0.0f)
+				return true; // Crosses the near plane
+
+			const float invW = 1.0f / p.w;
+			minX = std::min(minX, p.x * invW); maxX = std::max(maxX, p.x * invW);
+			minY = std::min(minY, p.y * invW); maxY = std::max(maxY, p.y * invW);
+			minZ = std::min(minZ, p.z * invW);
+		}
+#endif
+
+		// Off screen boxes are left to frustum culling
+		if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+			return true;
+
+		const int x0 = std::clamp(static_cast<int>((minX + 1.0f) * 0.5f * m_width), 0, m_width - 1);
+		const int x1 = std::clamp(static_cast<int>((maxX + 1.0f) * 0.5f * m_width), 0, m_width - 1);
+		const int y0 = std::clamp(static_cast<int>((1.0f - maxY) * 0.5f * m_height), 0, m_height - 1);
+		const int y1 = std::clamp(static_cast<int>((1.0f - minY) * 0.5f * m_height), 0, m_height - 1);
+
+		// Pick the level where the rectangle covers at most 2x2 texels
+		size_t level = 0;
+		while (level + 1 < m_levels.size() && (((x1 >> level) - (x0 >> level)) > 1 || ((y1 >> level) - (y0 >> level)) > 1))
+			level++;
+
+		const HiZLevel& hiz = m_levels[level];
+		float maxDepth = 0.0f;
+		for (int y = y0 >> level; y <= (y1 >> level); y++)
+		{
+			for (int x = x0 >> level; x <= (x1 >> level); x++)
+				maxDepth = std::max(maxDepth, hiz.depth[size_t(y) * hiz.width + x]);
+		}
+
+		return minZ <= maxDepth;
+	}
+
+	void OcclusionCuller::TestBounds(const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ, size_t count, uint8_t* visible) const
+	{
+		Parallel::ParallelFor(count, TestGrainSize, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				visible[i] = IsVisible(Math::Float3{ centerX[i], centerY[i], centerZ[i] }, Math::Float3{ extentX[i], extentY[i], extentZ[i] }) ? 1 : 0;
+		});
+	}
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <OcclusionCuller.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	constexpr int BlockCount = 16;			// City blocks along each horizontal axis
+	constexpr float BlockSpacing = 12.0f;	// Distance between building centers
+	constexpr float BuildingHalfWidth = 4.0f;
+	constexpr float EyeHeight = 1.7f;		// Camera height above the street
+	constexpr size_t ObjectsPerBlock = 400;
+	constexpr int FrameCount = 10;
+
+	// Unit cube spanning [-1, 1], scaled and placed by the world matrix
+	const Math::Float3 CubePositions[8] = {
+		{ -1.0f, -1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, -1.0f }, { -1.0f, 1.0f, -1.0f },
+		{ -1.0f, -1.0f, 1.0f }, { 1.0f, -1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { -1.0f, 1.0f, 1.0f }
+	};
+	const uint32_t CubeIndices[36] = {
+		0, 1, 2, 0, 2, 3,	4, 6, 5, 4, 7, 6,	0, 4, 5, 0, 5, 1,
+		3, 2, 6, 3, 6, 7,	0, 3, 7, 0, 7, 4,	1, 5, 6, 1, 6, 2
+	};
+
+	Math::Float4x4 Perspective(float xScale, float yScale, float zNear, float zFar)
+	{
+		Math::Float4x4 projection{};
+		projection.m[0][0] = xScale;
+		projection.m[1][1] = yScale;
+		projection.m[2][2] = zFar / (zFar - zNear);
+		projection.m[2][3] = 1.0f;
+		projection.m[3][2] = -zNear * zFar / (zFar - zNear);
+
+		return projection;
+	}
+
+	Math::Float4x4 ScaleTranslation(const Math::Float3& scale, const Math::Float3& translation)
+	{
+		Math::Float4x4 world = Math::Float4x4::Identity;
+		world.m[0][0] = scale.x;
+		world.m[1][1] = scale.y;
+		world.m[2][2] = scale.z;
+		world.m[3][0] = translation.x;
+		world.m[3][1] = translation.y;
+		world.m[3][2] = translation.z;
+
+		return world;
+	}
+
+	// Deterministic pseudo random value in [0, 1)
+	float Hash(uint32_t value)
+	{
+		value ^= value >> 16;
+		value *= 0x7FEB352Du;
+		value ^= value >> 15;
+		value *= 0x846CA68Bu;
+		value ^= value >> 16;
+
+		return static_cast<float>(value >> 8) / 16777216.0f;
+	}
+}
+
+// Street level view down a grid of buildings with many small props scattered between them. Reports how many props
+// the Hi-Z test rejects and how long rasterization and testing take per frame
+TEST(OcclusionCullerBenchmark, DenseCity)
+{
+	// The camera stands in the street between the first two columns of buildings, looking down +z. 2:1 aspect to match the default buffer
+	const Math::Float3 camera = { BlockSpacing * 0.5f, EyeHeight, 0.0f };
+	const Math::Float4x4 projection = Perspective(0.5f, 1.0f, 0.1f, 1000.0f);
+	Math::Float4x4 viewProj = projection;
+	viewProj.m[3][0] -= camera.x * projection.m[0][0];
+	viewProj.m[3][1] -= camera.y * projection.m[1][1];
+
+	std::vector<Math::Float4x4> buildings;
+	std::vector<float> centerX, centerY, centerZ, extentX, extentY, extentZ;
+	for (int bz = 0; bz < BlockCount; bz++)
+	{
+		for (int bx = -BlockCount / 2; bx < BlockCount / 2; bx++)
+		{
+			const uint32_t block = static_cast<uint32_t>((bz * BlockCount + bx + BlockCount) * 7919);
+			const float x = bx * BlockSpacing;
+			const float z = BlockSpacing + bz * BlockSpacing;
+			const float halfHeight = 10.0f + 10.0f * Hash(block);
+			buildings.push_back(ScaleTranslation({ BuildingHalfWidth, halfHeight, BuildingHalfWidth }, { x, halfHeight, z }));
+
+			// Props in the streets around the building
+			for (size_t i = 0; i < ObjectsPerBlock; i++)
+			{
+				const uint32_t seed = block + static_cast<uint32_t>(i) * 3;
+				centerX.push_back(x + (Hash(seed) - 0.5f) * BlockSpacing);
+				centerY.push_back(0.5f);
+				centerZ.push_back(z + (Hash(seed + 1) - 0.5f) * BlockSpacing);
+				const float extent = 0.1f + 0.4f * Hash(seed + 2);
+				extentX.push_back(extent);
+				extentY.push_back(extent);
+				extentZ.push_back(extent);
+			}
+		}
+	}
+
+	const size_t objectCount = centerX.size();
+	std::vector<uint8_t> visible(objectCount);
+	OcclusionCuller culler;
+
+	double rasterMs = 0.0;
+	double testMs = 0.0;
+	for (int frame = 0; frame < FrameCount; frame++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		culler.BeginFrame(viewProj);
+		for (const Math::Float4x4& world : buildings)
+			culler.AddOccluder(CubePositions, 8, sizeof(Math::Float3), CubeIndices, 36, world);
+		culler.Finalize();
+
+		const auto rasterized = std::chrono::steady_clock::now();
+
+		culler.TestBounds(centerX.data(), centerY.data(), centerZ.data(), extentX.data(), extentY.data(), extentZ.data(), objectCount, visible.data());
+
+		const auto tested = std::chrono::steady_clock::now();
+		rasterMs += std::chrono::duration<double, std::milli>(rasterized - start).count();
+		testMs += std::chrono::duration<double, std::milli>(tested - rasterized).count();
+	}
+
+	size_t rejected = 0;
+	for (uint8_t flag : visible)
+		rejected += flag ? 0 : 1;
+
+	std::cout << "[ BENCHMARK] " << buildings.size() << " occluders, " << objectCount << " objects, " << rejected << " rejected ("
+		<< (100.0 * rejected / objectCount) << "%), raster " << rasterMs / FrameCount << " ms, test " << testMs / FrameCount << " ms per frame" << std::endl;
+
+	RecordProperty("Rejected", static_cast<int>(rejected));
+
+	// Looking down a street most of the city is hidden behind the first rows of buildings
+	EXPECT_GT(rejected, objectCount / 2);
+	EXPECT_LT(rejected, objectCount);
+
+	// Props in the open street right in front of the camera must survive
+	EXPECT_TRUE(culler.IsVisible({ camera.x, 0.5f, 4.0f }, { 0.25f, 0.25f, 0.25f }));
+}
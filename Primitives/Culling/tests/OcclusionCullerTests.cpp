@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <OcclusionCuller.h>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	// Row-vector perspective projection looking down +z with a [0, 1] depth range, camera at the origin
+	Math::Float4x4 Perspective(float xScale, float yScale, float zNear, float zFar)
+	{
+		Math::Float4x4 projection{};
+		projection.m[0][0] = xScale;
+		projection.m[1][1] = yScale;
+		projection.m[2][2] = zFar / (zFar - zNear);
+		projection.m[2][3] = 1.0f;
+		projection.m[3][2] = -zNear * zFar / (zFar - zNear);
+
+		return projection;
+	}
+
+	// 10x10 wall facing the camera at z = 10
+	const Math::Float3 WallPositions[4] = { { -5.0f, -5.0f, 10.0f }, { 5.0f, -5.0f, 10.0f }, { 5.0f, 5.0f, 10.0f }, { -5.0f, 5.0f, 10.0f } };
+	const uint32_t WallIndices[6] = { 0, 1, 2, 0, 2, 3 };
+
+	class OcclusionCullerTests : public ::testing::Test
+	{
+	protected:
+		OcclusionCuller m_culler;
+
+		void SetUp() override
+		{
+			m_culler.BeginFrame(Perspective(1.0f, 1.0f, 0.1f, 1000.0f));
+			m_culler.AddOccluder(WallPositions, 4, sizeof(Math::Float3), WallIndices, 6, Math::Float4x4::Identity);
+			m_culler.Finalize();
+		}
+	};
+}
+
+TEST_F(OcclusionCullerTests, BuildsPyramid)
+{
+	EXPECT_EQ(m_culler.GetTriangleCount(), 2u);
+	EXPECT_GT(m_culler.GetLevelCount(), 1u);
+}
+
+TEST_F(OcclusionCullerTests, RejectsFullyOccludedBox)
+{
+	EXPECT_FALSE(m_culler.IsVisible({ 0.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 1.0f }));
+}
+
+TEST_F(OcclusionCullerTests, KeepsBoxInFrontOfOccluder)
+{
+	EXPECT_TRUE(m_culler.IsVisible({ 0.0f, 0.0f, 5.0f }, { 1.0f, 1.0f, 1.0f }));
+}
+
+TEST_F(OcclusionCullerTests, KeepsPartiallyOccludedBox)
+{
+	EXPECT_TRUE(m_culler.IsVisible({ 10.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 1.0f }));
+}
+
+TEST_F(OcclusionCullerTests, KeepsBoxBesideOccluder)
+{
+	// On screen just past the wall's right edge, which projects to x = 0.5
+	EXPECT_TRUE(m_culler.IsVisible({ 13.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 1.0f }));
+	EXPECT_TRUE(m_culler.IsVisible({ 0.0f, 13.0f, 20.0f }, { 1.0f, 1.0f, 1.0f }));
+}
+
+TEST_F(OcclusionCullerTests, TestBoundsMatchesIsVisible)
+{
+	const float centerX[4] = { 0.0f, 0.0f, 10.0f, 13.0f };
+	const float centerY[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const float centerZ[4] = { 20.0f, 5.0f, 20.0f, 20.0f };
+	const float extent[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	uint8_t visible[4];
+
+	m_culler.TestBounds(centerX, centerY, centerZ, extent, extent, extent, 4, visible);
+
+	for (size_t i = 0; i < 4; i++)
+		EXPECT_EQ(visible[i] != 0, m_culler.IsVisible({ centerX[i], centerY[i], centerZ[i] }, { extent[i], extent[i], extent[i] })) << "box " << i;
+}
+
+TEST(OcclusionCullerConstruction, WideBufferRasterizesOccluders)
+{
+	// Wall spanning the full width of a buffer whose pixel coordinates pass the int16_t range, seen through a narrow x scale so
+	// the boxes stay a few pixels wide
+	const Math::Float3 positions[4] = { { -1000.0f, -5.0f, 10.0f }, { 1000.0f, -5.0f, 10.0f }, { 1000.0f, 5.0f, 10.0f }, { -1000.0f, 5.0f, 10.0f } };
+	OcclusionCuller culler(40000, 128);
+	culler.BeginFrame(Perspective(0.01f, 1.0f, 0.1f, 1000.0f));
+	culler.AddOccluder(positions, 4, sizeof(Math::Float3), WallIndices, 6, Math::Float4x4::Identity);
+	culler.Finalize();
+
+	EXPECT_FALSE(culler.IsVisible({ 0.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 1.0f }));
+	EXPECT_TRUE(culler.IsVisible({ 0.0f, 13.0f, 20.0f }, { 1.0f, 1.0f, 1.0f }));
+}
+
+TEST(OcclusionCullerConstruction, ThrowsOnZeroSize)
+{
+	EXPECT_THROW(OcclusionCuller(0, 128), std::invalid_argument);
+	EXPECT_THROW(OcclusionCuller(256, 0), std::invalid_argument);
+}
@@ -0,0 +1,68 @@
+#ifndef ULTREALITY_RENDERING_LOD_CHAIN_H
+#define ULTREALITY_RENDERING_LOD_CHAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Geometry to build a level of detail chain from. The pointers must stay valid while the chain is generated
+	/// </summary>
+	struct LODSourceMesh
+	{
+		const Math::Float3* positions;	// Pointer to the position of the first vertex
+		size_t vertexCount;
+		size_t positionStride;			// Number of bytes between consecutive positions
+		const uint32_t* indices;		// Triangle list indices
+		size_t indexCount;
+	};
+
+	/// <summary>
+	/// A single level of detail. It indexes the vertex buffer of the source mesh
+	/// </summary>
+	struct MeshLOD
+	{
+		std::vector<uint32_t> indices;
+		float error; // Simplification error relative to the size of the mesh bounds
+	};
+
+	using LODChain = std::vector<MeshLOD>;
+
+	struct LODChainSettings
+	{
+		uint32_t maxLevels = 4;			// Maximum number of levels, including the source mesh at level 0
+		float reductionRatio = 0.5f;	// Index count of each level relative to the previous level
+		float maxError = 0.05f;			// Largest error a level may have, relative to the size of the mesh bounds
+		size_t minIndexCount = 36;		// Meshes are not reduced below this many indices
+	};
+
+	/// <summary>
+	/// Generates level of detail chains with <see cref="MeshSimplifier"/>
+	/// </summary>
+	class LODGenerator
+	{
+	public:
+		/// <summary>
+		/// Generate the level of detail chain of a single mesh. Level 0 is a copy of the source indices, generation stops
+		/// once a level can not be reduced further within the error and size limits
+		/// </summary>
+		/// <param name="mesh">Mesh to generate the levels for</param>
+		/// <param name="settings">Limits of the chain</param>
+		/// <returns>The levels, ordered from most to least detailed</returns>
+		static LODChain GenerateChain(const LODSourceMesh& mesh, const LODChainSettings& settings);
+
+		/// <summary>
+		/// Generate the level of detail chains of many meshes in parallel
+		/// </summary>
+		/// <param name="meshes">Meshes to generate the levels for</param>
+		/// <param name="settings">Limits of the chains</param>
+		/// <returns>One chain per mesh, in the order of meshes</returns>
+		static std::vector<LODChain> GenerateChains(const std::vector<LODSourceMesh>& meshes, const LODChainSettings& settings);
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_LOD_CHAIN_H
@@ -0,0 +1,75 @@
+#ifndef ULTREALITY_RENDERING_LOD_SELECTOR_H
+#define ULTREALITY_RENDERING_LOD_SELECTOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include <vector>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	struct LODSelectionSettings
+	{
+		static constexpr size_t MaxLevels = 8;
+
+		// Projected screen size (bounding sphere diameter as a fraction of the screen height) below which each coarser level is used.
+		// thresholds[i] is the switch from level i to level i + 1, and must be decreasing
+		std::array<float, MaxLevels - 1> thresholds = { 0.5f, 0.25f, 0.125f, 0.0625f, 0.03125f, 0.015625f, 0.0078125f };
+		float bias = 1.0f;		// Multiplies the projected size. Above 1 keeps detail further away, below 1 switches to coarser levels sooner
+		uint8_t minLevel = 0;	// Most detailed level that may be selected
+	};
+
+	/// <summary>
+	/// Picks a level of detail per object from its projected screen size. Object bounds are kept as SoA and selected in parallel batches
+	/// </summary>
+	class LODSelector
+	{
+	protected:
+		std::vector<float> m_centerX;
+		std::vector<float> m_centerY;
+		std::vector<float> m_centerZ;
+		std::vector<float> m_radius;
+		std::vector<uint8_t> m_levelCount;
+
+	public:
+		/// <summary>
+		/// Add an object to select levels for
+		/// </summary>
+		/// <param name="center">World space bounding sphere center</param>
+		/// <param name="radius">Bounding sphere radius</param>
+		/// <param name="levelCount">Number of levels in the object's chain, at least 1</param>
+		/// <returns>Index of the object, used to read the selection result</returns>
+		size_t AddObject(const Math::Float3& center, float radius, uint8_t levelCount);
+
+		/// <summary>
+		/// Update the bounds of an object that moved
+		/// </summary>
+		void SetBounds(size_t object, const Math::Float3& center, float radius) noexcept;
+
+		/// <summary>
+		/// Remove every object
+		/// </summary>
+		void Clear() noexcept;
+
+		/// <summary>
+		/// Get the number of objects
+		/// </summary>
+		size_t GetObjectCount() const noexcept
+		{
+			return m_radius.size();
+		}
+
+		/// <summary>
+		/// Select the level of every object
+		/// </summary>
+		/// <param name="cameraPosition">World space position of the camera</param>
+		/// <param name="projectionScale">Vertical projection scale, 1 / tan(verticalFov / 2). Element [1][1] of a perspective projection matrix</param>
+		/// <param name="settings">Thresholds and quality bias, see <see cref="MakeLODSelectionSettings"/> to derive them from the renderer settings</param>
+		/// <param name="levels">Output, resized to the object count and filled with the selected level of each object</param>
+		void Select(const Math::Float3& cameraPosition, float projectionScale, const LODSelectionSettings& settings, std::vector<uint8_t>& levels) const;
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_LOD_SELECTOR_H
@@ -0,0 +1,37 @@
+#ifndef ULTREALITY_RENDERING_MESH_SIMPLIFIER_H
+#define ULTREALITY_RENDERING_MESH_SIMPLIFIER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Reduces the triangle count of indexed meshes with quadric error metric edge collapses.
+	/// Edges collapse onto one of their existing vertices, so every level of detail shares the source vertex buffer and only needs a new index buffer
+	/// </summary>
+	class MeshSimplifier
+	{
+	public:
+		/// <summary>
+		/// Simplify an indexed triangle list
+		/// </summary>
+		/// <param name="positions">Pointer to the position of the first vertex</param>
+		/// <param name="vertexCount">Number of vertices</param>
+		/// <param name="positionStride">Number of bytes between consecutive positions</param>
+		/// <param name="indices">Triangle list indices</param>
+		/// <param name="indexCount">Number of indices, must be a multiple of 3</param>
+		/// <param name="targetIndexCount">Number of indices to reduce the mesh to. Simplification stops early if targetError would be exceeded</param>
+		/// <param name="targetError">Largest allowed error, relative to the size of the mesh bounds (0.01 = 1% of the mesh extent)</param>
+		/// <param name="result">Output, receives the simplified triangle list</param>
+		/// <returns>The error of the simplified mesh relative to the size of the mesh bounds</returns>
+		/// <exception cref="std.invalid_argument">Thrown if indexCount is not a multiple of 3</exception>
+		/// <exception cref="std.out_of_range">Thrown if an index references a vertex past vertexCount</exception>
+		static float Simplify(const Math::Float3* positions, size_t vertexCount, size_t positionStride, const uint32_t* indices, size_t indexCount, size_t targetIndexCount, float targetError, std::vector<uint32_t>& result);
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_MESH_SIMPLIFIER_H
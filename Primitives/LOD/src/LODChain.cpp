@@ -0,0 +1,70 @@
+#include <LODChain.h>
+#include <MeshSimplifier.h>
+#include <ParallelFor.h>
+
+#include <exception>
+
+namespace UltReality::Rendering
+{
+	LODChain LODGenerator::GenerateChain(const LODSourceMesh& mesh, const LODChainSettings& settings)
+	{
+		LODChain chain;
+		chain.reserve(settings.maxLevels);
+		chain.push_back(MeshLOD{ std::vector<uint32_t>(mesh.indices, mesh.indices + mesh.indexCount), 0.0f });
+
+		while (chain.size() < settings.maxLevels)
+		{
+			const std::vector<uint32_t>& previous = chain.back().indices;
+			const size_t target = static_cast<size_t>(static_cast<float>(previous.size() / 3) * settings.reductionRatio) * 3;
+			if (target < settings.minIndexCount)
+				break;
+
+			// Errors accumulate along the chain since each level is simplified from the previous one, so each level only gets what is left of the budget
+			const float remainingError = settings.maxError - chain.back().error;
+			if (remainingError <= 0.0f)
+				break;
+
+			MeshLOD level;
+			level.error = MeshSimplifier::Simplify(mesh.positions, mesh.vertexCount, mesh.positionStride, previous.data(), previous.size(), target, remainingError, level.indices);
+			level.error += chain.back().error;
+
+			// Stop once the simplifier can no longer make meaningful progress within the error budget
+			if (level.indices.empty() || level.indices.size() >= previous.size() || level.error > settings.maxError)
+				break;
+
+			chain.push_back(std::move(level));
+		}
+
+		return chain;
+	}
+
+	std::vector<LODChain> LODGenerator::GenerateChains(const std::vector<LODSourceMesh>& meshes, const LODChainSettings& settings)
+	{
+		std::vector<LODChain> chains(meshes.size());
+		std::vector<std::exception_ptr> errors(meshes.size());
+
+		// One mesh per task, meshes vary wildly in cost
+		Parallel::ParallelFor(meshes.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				try
+				{
+					chains[i] = GenerateChain(meshes[i], settings);
+				}
+				catch (...)
+				{
+					errors[i] = std::current_exception();
+				}
+			}
+		});
+
+		for (const std::exception_ptr& error : errors)
+		{
+			if (error)
+				std::rethrow_exception(error);
+		}
+
+		return chains;
+	}
+}
@@ -0,0 +1,109 @@
+#include <LODSelector.h>
+#include <ParallelFor.h>
+#include <RenderingSIMD.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		constexpr size_t SelectGrainSize = 2048;
+		constexpr float MinimumDistance = 1e-4f;
+
+		inline uint8_t ClampLevel(int level, uint8_t minLevel, uint8_t levelCount) noexcept
+		{
+			const int coarsest = std::max(static_cast<int>(levelCount) - 1, 0);
+			return static_cast<uint8_t>(std::min(std::max(level, static_cast<int>(minLevel)), coarsest));
+		}
+	}
+
+	size_t LODSelector::AddObject(const Math::Float3& center, float radius, uint8_t levelCount)
+	{
+		m_centerX.push_back(center.x);
+		m_centerY.push_back(center.y);
+		m_centerZ.push_back(center.z);
+		m_radius.push_back(radius);
+		m_levelCount.push_back(std::max<uint8_t>(levelCount, 1));
+
+		return m_radius.size() - 1;
+	}
+
+	void LODSelector::SetBounds(size_t object, const Math::Float3& center, float radius) noexcept
+	{
+		m_centerX[object] = center.x;
+		m_centerY[object] = center.y;
+		m_centerZ[object] = center.z;
+		m_radius[object] = radius;
+	}
+
+	void LODSelector::Clear() noexcept
+	{
+		m_centerX.clear();
+		m_centerY.clear();
+		m_centerZ.clear();
+		m_radius.clear();
+		m_levelCount.clear();
+	}
+
+	void LODSelector::Select(const Math::Float3& cameraPosition, float projectionScale, const LODSelectionSettings& settings, std::vector<uint8_t>& levels) const
+	{
+		const size_t count = m_radius.size();
+		levels.resize(count);
+
+		// Fold the bias into the scale so a single multiply gives the biased screen size
+		const float scale = projectionScale * settings.bias;
+
+		Parallel::ParallelFor(count, SelectGrainSize, [&](size_t begin, size_t end)
+		{
+			size_t i = begin;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+			const __m128 camX = _mm_set1_ps(cameraPosition.x);
+			const __m128 camY = _mm_set1_ps(cameraPosition.y);
+			const __m128 camZ = _mm_set1_ps(cameraPosition.z);
+			const __m128 scaleV = _mm_set1_ps(scale);
+			const __m128 minDistance = _mm_set1_ps(MinimumDistance);
+
+			__m128 thresholds[LODSelectionSettings::MaxLevels - 1];
+			for (size_t t = 0; t < settings.thresholds.size(); t++)
+				thresholds[t] = _mm_set1_ps(settings.thresholds[t]);
+
+			alignas(16) int32_t selected[4];
+			for (; i + 4 <= end; i += 4)
+			{
+				const __m128 dx = _mm_sub_ps(_mm_loadu_ps(m_centerX.data() + i), camX);
+				const __m128 dy = _mm_sub_ps(_mm_loadu_ps(m_centerY.data() + i), camY);
+				const __m128 dz = _mm_sub_ps(_mm_loadu_ps(m_centerZ.data() + i), camZ);
+				const __m128 distance = _mm_max_ps(_mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz))), minDistance);
+				const __m128 size = _mm_div_ps(_mm_mul_ps(_mm_loadu_ps(m_radius.data() + i), scaleV), distance);
+
+				// Count the thresholds the size falls below, compare masks are -1 so subtracting them increments the level
+				__m128i level = _mm_setzero_si128();
+				for (size_t t = 0; t < settings.thresholds.size(); t++)
+					level = _mm_sub_epi32(level, _mm_castps_si128(_mm_cmplt_ps(size, thresholds[t])));
+
+				_mm_store_si128(reinterpret_cast<__m128i*>(selected), level);
+				for (size_t lane = 0; lane < 4; lane++)
+					levels[i + lane] = ClampLevel(selected[lane], settings.minLevel, m_levelCount[i + lane]);
+			}
+#endif
+
+			for (; i < end; i++)
+			{
+				const float dx = m_centerX[i] - cameraPosition.x;
+				const float dy = m_centerY[i] - cameraPosition.y;
+				const float dz = m_centerZ[i] - cameraPosition.z;
+				const float distance = std::max(std::sqrt(dx * dx + dy * dy + dz * dz), MinimumDistance);
+				const float size = m_radius[i] * scale / distance;
+
+				int level = 0;
+				for (const float threshold : settings.thresholds)
+					level += size < threshold ? 1 : 0;
+
+				levels[i] = ClampLevel(level, settings.minLevel, m_levelCount[i]);
+			}
+		});
+	}
+}
@@ -0,0 +1,319 @@
+#include <MeshSimplifier.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		// Boundary edges are held in place by a constraint plane this many times heavier than a regular triangle
+		constexpr double BoundaryWeight = 10.0;
+
+		struct Vec3
+		{
+			double x, y, z;
+		};
+
+		inline Vec3 Sub(const Vec3& a, const Vec3& b) noexcept
+		{
+			return Vec3{ a.x - b.x, a.y - b.y, a.z - b.z };
+		}
+
+		inline Vec3 Cross(const Vec3& a, const Vec3& b) noexcept
+		{
+			return Vec3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+		}
+
+		inline double Dot(const Vec3& a, const Vec3& b) noexcept
+		{
+			return a.x * b.x + a.y * b.y + a.z * b.z;
+		}
+
+		inline double Length(const Vec3& a) noexcept
+		{
+			return std::sqrt(Dot(a, a));
+		}
+
+		/// Symmetric 4x4 plane quadric with the accumulated plane weight, so the evaluated error is a weighted mean squared distance
+		struct Quadric
+		{
+			double a2 = 0, ab = 0, ac = 0, ad = 0;
+			double b2 = 0, bc = 0, bd = 0;
+			double c2 = 0, cd = 0;
+			double d2 = 0;
+			double weight = 0;
+
+			void AddPlane(const Vec3& n, double d, double w) noexcept
+			{
+				a2 += w * n.x * n.x; ab += w * n.x * n.y; ac += w * n.x * n.z; ad += w * n.x * d;
+				b2 += w * n.y * n.y; bc += w * n.y * n.z; bd += w * n.y * d;
+				c2 += w * n.z * n.z; cd += w * n.z * d;
+				d2 += w * d * d;
+				weight += w;
+			}
+
+			Quadric& operator+=(const Quadric& o) noexcept
+			{
+				a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad;
+				b2 += o.b2; bc += o.bc; bd += o.bd;
+				c2 += o.c2; cd += o.cd;
+				d2 += o.d2;
+				weight += o.weight;
+				return *this;
+			}
+
+			double Evaluate(const Vec3& p) const noexcept
+			{
+				const double error = a2 * p.x * p.x + 2.0 * ab * p.x * p.y + 2.0 * ac * p.x * p.z + 2.0 * ad * p.x
+					+ b2 * p.y * p.y + 2.0 * bc * p.y * p.z + 2.0 * bd * p.y
+					+ c2 * p.z * p.z + 2.0 * cd * p.z
+					+ d2;
+
+				return weight > 0.0 ? std::abs(error) / weight : 0.0;
+			}
+		};
+
+		struct Collapse
+		{
+			uint32_t from;
+			uint32_t to;
+			double cost;
+		};
+
+		inline uint64_t EdgeKey(uint32_t a, uint32_t b) noexcept
+		{
+			return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+		}
+
+		void RemoveDegenerateTriangles(std::vector<uint32_t>& indices) noexcept
+		{
+			size_t write = 0;
+			for (size_t read = 0; read < indices.size(); read += 3)
+			{
+				const uint32_t a = indices[read], b = indices[read + 1], c = indices[read + 2];
+				if (a == b || b == c || a == c)
+					continue;
+
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+			indices.resize(write);
+		}
+	}
+
+	float MeshSimplifier::Simplify(const Math::Float3* positions, size_t vertexCount, size_t positionStride, const uint32_t* indices, size_t indexCount, size_t targetIndexCount, float targetError, std::vector<uint32_t>& result)
+	{
+		if (indexCount % 3 != 0)
+			throw std::invalid_argument("Simplify index count must be a multiple of 3");
+
+		result.assign(indices, indices + indexCount);
+		for (const uint32_t index : result)
+		{
+			if (index >= vertexCount)
+				throw std::out_of_range("Simplify index references a vertex past the end of the vertex buffer");
+		}
+
+		RemoveDegenerateTriangles(result);
+		if (result.size() <= targetIndexCount)
+			return 0.0f;
+
+		// Work in doubles, normalized to the mesh extent so errors are scale independent
+		std::vector<Vec3> points(vertexCount);
+		Vec3 minimum{ std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+		Vec3 maximum{ std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			const Math::Float3& p = *reinterpret_cast<const Math::Float3*>(reinterpret_cast<const uint8_t*>(positions) + positionStride * i);
+			points[i] = Vec3{ p.x, p.y, p.z };
+		}
+		for (const uint32_t index : result)
+		{
+			const Vec3& p = points[index];
+			minimum = Vec3{ std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+			maximum = Vec3{ std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+		}
+
+		const double extent = std::max({ maximum.x - minimum.x, maximum.y - minimum.y, maximum.z - minimum.z, 1e-12 });
+		const double invExtent = 1.0 / extent;
+		for (Vec3& p : points)
+			p = Vec3{ (p.x - minimum.x) * invExtent, (p.y - minimum.y) * invExtent, (p.z - minimum.z) * invExtent };
+
+		// Accumulate the area weighted plane of every triangle into its vertices
+		std::vector<Quadric> quadrics(vertexCount);
+		std::vector<std::pair<uint64_t, uint32_t>> edges; // (edge, opposite triangle) for boundary detection
+		edges.reserve(result.size());
+		for (size_t t = 0; t < result.size(); t += 3)
+		{
+			const Vec3& p0 = points[result[t]];
+			const Vec3 normal = Cross(Sub(points[result[t + 1]], p0), Sub(points[result[t + 2]], p0));
+			const double area = Length(normal);
+			if (area <= 0.0)
+				continue;
+
+			const Vec3 n{ normal.x / area, normal.y / area, normal.z / area };
+			const double d = -Dot(n, p0);
+			for (size_t k = 0; k < 3; k++)
+			{
+				quadrics[result[t + k]].AddPlane(n, d, area);
+				edges.emplace_back(EdgeKey(result[t + k], result[t + (k + 1) % 3]), static_cast<uint32_t>(t));
+			}
+		}
+
+		// Edges used by a single triangle lie on a boundary. Constrain them with a plane perpendicular to the triangle
+		std::sort(edges.begin(), edges.end());
+		for (size_t i = 0; i < edges.size();)
+		{
+			size_t j = i + 1;
+			while (j < edges.size() && edges[j].first == edges[i].first)
+				j++;
+
+			if (j - i == 1)
+			{
+				const uint32_t a = static_cast<uint32_t>(edges[i].first >> 32);
+				const uint32_t b = static_cast<uint32_t>(edges[i].first & 0xffffffffu);
+				const size_t t = edges[i].second;
+				const Vec3& p0 = points[result[t]];
+				const Vec3 faceNormal = Cross(Sub(points[result[t + 1]], p0), Sub(points[result[t + 2]], p0));
+				const Vec3 edge = Sub(points[b], points[a]);
+				Vec3 n = Cross(edge, faceNormal);
+				const double length = Length(n);
+				if (length > 0.0)
+				{
+					n = Vec3{ n.x / length, n.y / length, n.z / length };
+					const double d = -Dot(n, points[a]);
+					const double w = Dot(edge, edge) * BoundaryWeight;
+					quadrics[a].AddPlane(n, d, w);
+					quadrics[b].AddPlane(n, d, w);
+				}
+			}
+
+			i = j;
+		}
+
+		const double maxCost = static_cast<double>(targetError) * static_cast<double>(targetError);
+		double achievedCost = 0.0;
+
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint8_t> locked(vertexCount);
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<uint64_t> edgeKeys;
+
+		// Each pass collapses a batch of independent edges in cost order, then rebuilds the connectivity
+		while (result.size() > targetIndexCount)
+		{
+			edgeKeys.clear();
+			for (size_t t = 0; t < result.size(); t += 3)
+			{
+				for (size_t k = 0; k < 3; k++)
+					edgeKeys.push_back(EdgeKey(result[t + k], result[t + (k + 1) % 3]));
+			}
+			std::sort(edgeKeys.begin(), edgeKeys.end());
+			edgeKeys.erase(std::unique(edgeKeys.begin(), edgeKeys.end()), edgeKeys.end());
+
+			collapses.clear();
+			for (const uint64_t key : edgeKeys)
+			{
+				const uint32_t a = static_cast<uint32_t>(key >> 32);
+				const uint32_t b = static_cast<uint32_t>(key & 0xffffffffu);
+				Quadric combined = quadrics[a];
+				combined += quadrics[b];
+
+				const double costToA = combined.Evaluate(points[a]);
+				const double costToB = combined.Evaluate(points[b]);
+				if (std::min(costToA, costToB) > maxCost)
+					continue;
+
+				collapses.push_back(costToA < costToB ? Collapse{ b, a, costToA } : Collapse{ a, b, costToB });
+			}
+
+			if (collapses.empty())
+				break;
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+			// Vertex -> triangle adjacency for the flip test
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (const uint32_t index : result)
+				adjacencyOffsets[index + 1]++;
+			for (size_t i = 0; i < vertexCount; i++)
+				adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+			adjacency.resize(result.size());
+			{
+				std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (size_t i = 0; i < result.size(); i++)
+					adjacency[cursor[result[i]]++] = static_cast<uint32_t>(i / 3 * 3);
+			}
+
+			for (size_t i = 0; i < vertexCount; i++)
+				remap[i] = static_cast<uint32_t>(i);
+			std::fill(locked.begin(), locked.end(), uint8_t(0));
+
+			size_t triangleEstimate = result.size() / 3;
+			const size_t targetTriangles = targetIndexCount / 3;
+			size_t collapsed = 0;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (triangleEstimate <= targetTriangles)
+					break;
+				if (locked[collapse.from] || locked[collapse.to])
+					continue;
+
+				// Reject collapses that would flip a surviving triangle around the moved vertex
+				bool flips = false;
+				size_t removedTriangles = 0;
+				for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1] && !flips; a++)
+				{
+					const uint32_t* tri = result.data() + adjacency[a];
+					if (tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to)
+					{
+						removedTriangles++;
+						continue;
+					}
+
+					Vec3 corners[3] = { points[tri[0]], points[tri[1]], points[tri[2]] };
+					const Vec3 before = Cross(Sub(corners[1], corners[0]), Sub(corners[2], corners[0]));
+					for (size_t k = 0; k < 3; k++)
+					{
+						if (tri[k] == collapse.from)
+							corners[k] = points[collapse.to];
+					}
+					const Vec3 after = Cross(Sub(corners[1], corners[0]), Sub(corners[2], corners[0]));
+
+					flips = Dot(before, after) <= 0.0;
+				}
+
+				if (flips)
+					continue;
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to] += quadrics[collapse.from];
+				achievedCost = std::max(achievedCost, collapse.cost);
+				triangleEstimate -= std::min(triangleEstimate, removedTriangles);
+				collapsed++;
+
+				// Lock the whole neighbourhood so the adjacency stays valid for the rest of the pass
+				for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++)
+				{
+					const uint32_t* tri = result.data() + adjacency[a];
+					locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+				}
+			}
+
+			if (collapsed == 0)
+				break;
+
+			for (uint32_t& index : result)
+				index = remap[index];
+			RemoveDegenerateTriangles(result);
+		}
+
+		return static_cast<float>(std::sqrt(achievedCost));
+	}
+}
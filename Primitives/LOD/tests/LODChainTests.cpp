@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <LODChain.h>
+#include <MeshSimplifier.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	struct TestMesh
+	{
+		std::vector<Math::Float3> positions;
+		std::vector<uint32_t> indices;
+
+		LODSourceMesh Source() const
+		{
+			return LODSourceMesh{ positions.data(), positions.size(), sizeof(Math::Float3), indices.data(), indices.size() };
+		}
+	};
+
+	// Closed unit sphere
+	TestMesh MakeSphere(uint32_t slices, uint32_t stacks)
+	{
+		TestMesh mesh;
+		for (uint32_t r = 0; r <= stacks; r++)
+		{
+			for (uint32_t s = 0; s <= slices; s++)
+			{
+				const float theta = 3.14159265f * r / stacks;
+				const float phi = 6.28318531f * s / slices;
+				mesh.positions.push_back(Math::Float3{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) });
+			}
+		}
+		for (uint32_t r = 0; r < stacks; r++)
+		{
+			for (uint32_t s = 0; s < slices; s++)
+			{
+				const uint32_t a = r * (slices + 1) + s;
+				const uint32_t c = a + slices + 1;
+				mesh.indices.insert(mesh.indices.end(), { a, c, a + 1, a + 1, c, c + 1 });
+			}
+		}
+
+		return mesh;
+	}
+
+	// Open grid of size x size quads in the z = 0 plane, spanning [0, size] on x and y
+	TestMesh MakeGrid(uint32_t size)
+	{
+		TestMesh mesh;
+		for (uint32_t y = 0; y <= size; y++)
+		{
+			for (uint32_t x = 0; x <= size; x++)
+				mesh.positions.push_back(Math::Float3{ static_cast<float>(x), static_cast<float>(y), 0.0f });
+		}
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				const uint32_t a = y * (size + 1) + x;
+				const uint32_t c = a + size + 1;
+				mesh.indices.insert(mesh.indices.end(), { a, a + 1, c, a + 1, c + 1, c });
+			}
+		}
+
+		return mesh;
+	}
+
+	// Signed area of the triangle list projected onto the z = 0 plane
+	float ProjectedArea(const std::vector<Math::Float3>& positions, const std::vector<uint32_t>& indices)
+	{
+		float area = 0.0f;
+		for (size_t t = 0; t < indices.size(); t += 3)
+		{
+			const Math::Float3& a = positions[indices[t]];
+			const Math::Float3& b = positions[indices[t + 1]];
+			const Math::Float3& c = positions[indices[t + 2]];
+			area += 0.5f * ((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+		}
+
+		return area;
+	}
+}
+
+TEST(LODChain, ErrorGrowsAlongTheChainWithinBudget)
+{
+	const TestMesh sphere = MakeSphere(64, 32);
+
+	LODChainSettings settings;
+	settings.maxLevels = 6;
+	settings.maxError = 0.1f;
+	const LODChain chain = LODGenerator::GenerateChain(sphere.Source(), settings);
+
+	ASSERT_GE(chain.size(), 3u);
+	EXPECT_EQ(chain[0].indices, sphere.indices);
+	EXPECT_EQ(chain[0].error, 0.0f);
+	for (size_t level = 1; level < chain.size(); level++)
+	{
+		EXPECT_GE(chain[level].error, chain[level - 1].error) << "level " << level;
+		EXPECT_LE(chain[level].error, settings.maxError) << "level " << level;
+		EXPECT_LT(chain[level].indices.size(), chain[level - 1].indices.size()) << "level " << level;
+		EXPECT_GE(chain[level].indices.size(), settings.minIndexCount) << "level " << level;
+		EXPECT_EQ(chain[level].indices.size() % 3, 0u) << "level " << level;
+	}
+}
+
+TEST(LODChain, TighterBudgetNeverAllowsMoreError)
+{
+	const TestMesh sphere = MakeSphere(48, 24);
+
+	LODChainSettings loose;
+	loose.maxLevels = 6;
+	loose.maxError = 0.2f;
+	LODChainSettings tight = loose;
+	tight.maxError = 0.01f;
+
+	const LODChain looseChain = LODGenerator::GenerateChain(sphere.Source(), loose);
+	const LODChain tightChain = LODGenerator::GenerateChain(sphere.Source(), tight);
+
+	EXPECT_LE(tightChain.size(), looseChain.size());
+	for (const MeshLOD& level : tightChain)
+		EXPECT_LE(level.error, tight.maxError);
+}
+
+TEST(LODChain, ParallelChainsMatchSingleChain)
+{
+	const TestMesh sphere = MakeSphere(32, 16);
+	const TestMesh grid = MakeGrid(16);
+
+	LODChainSettings settings;
+	const std::vector<LODChain> chains = LODGenerator::GenerateChains({ sphere.Source(), grid.Source(), sphere.Source() }, settings);
+	ASSERT_EQ(chains.size(), 3u);
+
+	const LODChain expected = LODGenerator::GenerateChain(sphere.Source(), settings);
+	for (size_t mesh : { size_t(0), size_t(2) })
+	{
+		ASSERT_EQ(chains[mesh].size(), expected.size());
+		for (size_t level = 0; level < expected.size(); level++)
+			EXPECT_EQ(chains[mesh][level].indices, expected[level].indices);
+	}
+}
+
+TEST(MeshSimplifier, KeepsOpenGridBoundary)
+{
+	constexpr uint32_t Size = 16;
+	const TestMesh grid = MakeGrid(Size);
+
+	std::vector<uint32_t> simplified;
+	const float error = MeshSimplifier::Simplify(grid.positions.data(), grid.positions.size(), sizeof(Math::Float3), grid.indices.data(), grid.indices.size(), grid.indices.size() / 8, 0.01f, simplified);
+	ASSERT_FALSE(simplified.empty());
+	EXPECT_LT(simplified.size(), grid.indices.size() / 2);
+	EXPECT_LE(error, 0.01f);
+
+	// The outline survives, so the flat grid still covers exactly its square without folding over
+	EXPECT_NEAR(ProjectedArea(grid.positions, simplified), static_cast<float>(Size * Size), 1e-3f);
+
+	// Every edge used by a single triangle still lies on the square's border
+	std::map<std::pair<uint32_t, uint32_t>, int> edgeUses;
+	for (size_t t = 0; t < simplified.size(); t += 3)
+	{
+		for (size_t e = 0; e < 3; e++)
+		{
+			const uint32_t a = simplified[t + e];
+			const uint32_t b = simplified[t + (e + 1) % 3];
+			edgeUses[{ std::min(a, b), std::max(a, b) }]++;
+		}
+	}
+	const auto onBorder = [&](uint32_t a, uint32_t b)
+	{
+		const Math::Float3& p = grid.positions[a];
+		const Math::Float3& q = grid.positions[b];
+		return (p.x == q.x && (p.x == 0.0f || p.x == Size)) || (p.y == q.y && (p.y == 0.0f || p.y == Size));
+	};
+	for (const auto& [edge, uses] : edgeUses)
+	{
+		if (uses == 1)
+		{
+			EXPECT_TRUE(onBorder(edge.first, edge.second)) << "boundary edge " << edge.first << "-" << edge.second;
+		}
+	}
+
+	// The corners can not collapse along the border without changing the outline
+	for (const uint32_t corner : { 0u, Size, Size * (Size + 1), (Size + 1) * (Size + 1) - 1 })
+		EXPECT_NE(std::find(simplified.begin(), simplified.end(), corner), simplified.end()) << "corner " << corner;
+}
+
+TEST(MeshSimplifier, RejectsMalformedIndices)
+{
+	const TestMesh grid = MakeGrid(2);
+	std::vector<uint32_t> result;
+	EXPECT_THROW(MeshSimplifier::Simplify(grid.positions.data(), grid.positions.size(), sizeof(Math::Float3), grid.indices.data(), 4, 3, 0.1f, result), std::invalid_argument);
+
+	const uint32_t outOfRange[3] = { 0, 1, 100 };
+	EXPECT_THROW(MeshSimplifier::Simplify(grid.positions.data(), grid.positions.size(), sizeof(Math::Float3), outOfRange, 3, 3, 0.1f, result), std::out_of_range);
+}
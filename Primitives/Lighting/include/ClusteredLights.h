@@ -0,0 +1,116 @@
+#ifndef ULTREALITY_RENDERING_CLUSTERED_LIGHTS_H
+#define ULTREALITY_RENDERING_CLUSTERED_LIGHTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <VectorTypes.h>
+
+#include <Light.h>
+
+namespace UltReality::Rendering
+{
+	struct ClusterGridSettings
+	{
+		uint16_t tilesX = 16;				// Screen space tiles across the width
+		uint16_t tilesY = 9;				// Screen space tiles across the height
+		uint16_t slicesZ = 24;				// Exponentially distributed view space depth slices
+		uint16_t maxLightsPerCluster = 128;	// Caps the per-pixel light loop. Lights past the cap are dropped in light order
+		float nearZ = 0.1f;					// View space depth of the first slice
+		float farZ = 1000.0f;				// View space depth of the last slice
+	};
+
+	/// <summary>
+	/// Range of a cluster's entries in the light index list, one per cluster in the cluster Structured buffer
+	/// </summary>
+	struct ClusterLightRange
+	{
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	/// <summary>
+	/// Bins lights into a froxel grid (screen tiles x exponential depth slices) so each pixel only evaluates the lights of its cluster.
+	/// Clusters are indexed x + y * tilesX + z * tilesX * tilesY with y = 0 at the top of the screen.
+	/// Upload <see cref="GetClusters"/> and <see cref="GetLightIndices"/> with <c>CreateBuffer</c>/<c>UpdateBuffer</c> as <c>BufferType::Structured</c> buffers
+	/// </summary>
+	class ClusteredLightBuilder
+	{
+	protected:
+		struct ClusterBounds
+		{
+			float minX, minY, maxX, maxY; // View space x/y bounds of the cluster across its slice's depth range
+		};
+
+		ClusterGridSettings m_settings;
+		float m_tanHalfFovX = 1.0f;
+		float m_tanHalfFovY = 1.0f;
+		std::vector<float> m_sliceDepths;			// slicesZ + 1 boundaries
+		std::vector<ClusterBounds> m_clusterBounds;	// View space bounds per cluster
+
+		// Per frame data, lights in view space as SoA
+		std::vector<float> m_lightX;
+		std::vector<float> m_lightY;
+		std::vector<float> m_lightZ;
+		std::vector<float> m_lightRadius;
+
+		std::vector<ClusterLightRange> m_clusters;
+		std::vector<uint32_t> m_lightIndices;
+		std::vector<std::vector<uint32_t>> m_sliceIndices; // Per slice scratch, merged into m_lightIndices
+
+	public:
+		/// <summary>
+		/// Configure the grid and the camera projection. Must be called before <see cref="Build"/>, and again when the projection changes
+		/// </summary>
+		/// <param name="settings">Grid layout</param>
+		/// <param name="verticalFov">Vertical field of view in radians</param>
+		/// <param name="aspectRatio">Width divided by height</param>
+		/// <exception cref="std.invalid_argument">Thrown if the grid has no clusters or the depth range is invalid</exception>
+		void Configure(const ClusterGridSettings& settings, float verticalFov, float aspectRatio);
+
+		/// <summary>
+		/// Bin the lights of a frame into the clusters in parallel
+		/// </summary>
+		/// <param name="lights">World space lights, their order defines the indices written to the light index list</param>
+		/// <param name="lightCount">Number of lights</param>
+		/// <param name="view">Row-vector world to view matrix, looking down +z</param>
+		void Build(const Light* lights, size_t lightCount, const Math::Float4x4& view);
+
+		/// <summary>
+		/// Get the grid layout
+		/// </summary>
+		const ClusterGridSettings& GetSettings() const noexcept
+		{
+			return m_settings;
+		}
+
+		/// <summary>
+		/// Get the light range of every cluster from the last <see cref="Build"/>
+		/// </summary>
+		const std::vector<ClusterLightRange>& GetClusters() const noexcept
+		{
+			return m_clusters;
+		}
+
+		/// <summary>
+		/// Get the compact light index list from the last <see cref="Build"/>, indexes the lights passed to Build
+		/// </summary>
+		const std::vector<uint32_t>& GetLightIndices() const noexcept
+		{
+			return m_lightIndices;
+		}
+
+		/// <summary>
+		/// Get the scale used to compute a pixel's slice in a shader: slice = floor(log2(viewZ) * scale + bias)
+		/// </summary>
+		float GetSliceScale() const noexcept;
+
+		/// <summary>
+		/// Get the bias used to compute a pixel's slice in a shader: slice = floor(log2(viewZ) * scale + bias)
+		/// </summary>
+		float GetSliceBias() const noexcept;
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_CLUSTERED_LIGHTS_H
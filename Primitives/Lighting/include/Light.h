@@ -0,0 +1,34 @@
+#ifndef ULTREALITY_RENDERING_LIGHT_H
+#define ULTREALITY_RENDERING_LIGHT_H
+
+#include <stdint.h>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	enum class LightType : uint32_t
+	{
+		Point,
+		Spot
+	};
+
+	/// <summary>
+	/// A local light, laid out for upload as an element of a Structured buffer
+	/// </summary>
+	struct Light
+	{
+		Math::Float3 position;		// World space position
+		float range;				// Distance at which the light's contribution reaches 0
+		Math::Float3 color;			// Linear color
+		float intensity;
+		Math::Float3 direction;		// World space unit direction, spot lights only
+		float spotCosOuterAngle;	// Cosine of the cone's outer half angle, spot lights only
+		LightType type;
+		float spotCosInnerAngle;	// Cosine of the cone's inner half angle, spot lights only
+		float padding[2];
+	};
+	static_assert(sizeof(Light) % 16 == 0, "Light must be 16 byte aligned for Structured buffers");
+}
+
+#endif // !ULTREALITY_RENDERING_LIGHT_H
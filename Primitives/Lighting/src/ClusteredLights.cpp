@@ -0,0 +1,209 @@
+#include <ClusteredLights.h>
+#include <ParallelFor.h>
+#include <RenderingSIMD.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		// Spot cones narrower than this are bounded by the sphere around the cone rather than the sphere around the apex
+		constexpr float TightSpotCos = 0.70710678f;
+
+		inline bool SphereIntersectsBox(float x, float y, float z, float radius, float minX, float minY, float minZ, float maxX, float maxY, float maxZ) noexcept
+		{
+			const float dx = std::max({ minX - x, 0.0f, x - maxX });
+			const float dy = std::max({ minY - y, 0.0f, y - maxY });
+			const float dz = std::max({ minZ - z, 0.0f, z - maxZ });
+
+			return dx * dx + dy * dy + dz * dz <= radius * radius;
+		}
+	}
+
+	void ClusteredLightBuilder::Configure(const ClusterGridSettings& settings, float verticalFov, float aspectRatio)
+	{
+		if (settings.tilesX == 0 || settings.tilesY == 0 || settings.slicesZ == 0)
+			throw std::invalid_argument("Cluster grid must have at least one cluster on each axis");
+		if (settings.nearZ <= 0.0f || settings.farZ <= settings.nearZ)
+			throw std::invalid_argument("Cluster grid depth range must satisfy 0 < nearZ < farZ");
+
+		m_settings = settings;
+		m_tanHalfFovY = std::tan(verticalFov * 0.5f);
+		m_tanHalfFovX = m_tanHalfFovY * aspectRatio;
+
+		// Exponential slicing keeps clusters roughly cubic in view space
+		m_sliceDepths.resize(size_t(settings.slicesZ) + 1);
+		const float depthRatio = settings.farZ / settings.nearZ;
+		for (size_t k = 0; k <= settings.slicesZ; k++)
+			m_sliceDepths[k] = settings.nearZ * std::pow(depthRatio, static_cast<float>(k) / settings.slicesZ);
+
+		const size_t tilesPerSlice = size_t(settings.tilesX) * settings.tilesY;
+		m_clusterBounds.resize(tilesPerSlice * settings.slicesZ);
+		for (size_t k = 0; k < settings.slicesZ; k++)
+		{
+			const float zNear = m_sliceDepths[k];
+			const float zFar = m_sliceDepths[k + 1];
+			for (size_t j = 0; j < settings.tilesY; j++)
+			{
+				const float ndcTop = 1.0f - 2.0f * static_cast<float>(j) / settings.tilesY;
+				const float ndcBottom = 1.0f - 2.0f * static_cast<float>(j + 1) / settings.tilesY;
+				for (size_t i = 0; i < settings.tilesX; i++)
+				{
+					const float ndcLeft = -1.0f + 2.0f * static_cast<float>(i) / settings.tilesX;
+					const float ndcRight = -1.0f + 2.0f * static_cast<float>(i + 1) / settings.tilesX;
+
+					// The tile's frustum widens with depth, bound its corners at both depths
+					ClusterBounds& bounds = m_clusterBounds[k * tilesPerSlice + j * settings.tilesX + i];
+					bounds.minX = std::min(ndcLeft * zNear, ndcLeft * zFar) * m_tanHalfFovX;
+					bounds.maxX = std::max(ndcRight * zNear, ndcRight * zFar) * m_tanHalfFovX;
+					bounds.minY = std::min(ndcBottom * zNear, ndcBottom * zFar) * m_tanHalfFovY;
+					bounds.maxY = std::max(ndcTop * zNear, ndcTop * zFar) * m_tanHalfFovY;
+				}
+			}
+		}
+
+		m_clusters.assign(m_clusterBounds.size(), ClusterLightRange{ 0, 0 });
+		m_sliceIndices.resize(settings.slicesZ);
+	}
+
+	void ClusteredLightBuilder::Build(const Light* lights, size_t lightCount, const Math::Float4x4& view)
+	{
+		const auto& m = view.m;
+
+		// Bounding spheres in view space
+		m_lightX.resize(lightCount);
+		m_lightY.resize(lightCount);
+		m_lightZ.resize(lightCount);
+		m_lightRadius.resize(lightCount);
+		for (size_t l = 0; l < lightCount; l++)
+		{
+			const Light& light = lights[l];
+			Math::Float3 center = light.position;
+			float radius = light.range;
+
+			if (light.type == LightType::Spot && light.spotCosOuterAngle >= TightSpotCos)
+			{
+				// Sphere through the apex and the cap rim of a narrow cone
+				radius = light.range * 0.5f / light.spotCosOuterAngle;
+				center = Math::Float3{ center.x + light.direction.x * radius, center.y + light.direction.y * radius, center.z + light.direction.z * radius };
+			}
+
+			m_lightX[l] = center.x * m[0][0] + center.y * m[1][0] + center.z * m[2][0] + m[3][0];
+			m_lightY[l] = center.x * m[0][1] + center.y * m[1][1] + center.z * m[2][1] + m[3][1];
+			m_lightZ[l] = center.x * m[0][2] + center.y * m[1][2] + center.z * m[2][2] + m[3][2];
+			m_lightRadius[l] = radius;
+		}
+
+		const size_t tilesPerSlice = size_t(m_settings.tilesX) * m_settings.tilesY;
+		const uint32_t maxLights = m_settings.maxLightsPerCluster;
+
+		// One task per depth slice, each writes only its own clusters and scratch index list
+		Parallel::ParallelFor(m_settings.slicesZ, 1, [&](size_t sliceBegin, size_t sliceEnd)
+		{
+			std::vector<uint32_t> candidates;
+			std::vector<float> cx, cy, cz, cr;
+
+			for (size_t k = sliceBegin; k < sliceEnd; k++)
+			{
+				const float zNear = m_sliceDepths[k];
+				const float zFar = m_sliceDepths[k + 1];
+
+				// Lights overlapping the slice's depth range, gathered as SoA for the SIMD loop
+				candidates.clear();
+				cx.clear(); cy.clear(); cz.clear(); cr.clear();
+				for (size_t l = 0; l < lightCount; l++)
+				{
+					if (m_lightZ[l] + m_lightRadius[l] < zNear || m_lightZ[l] - m_lightRadius[l] > zFar)
+						continue;
+
+					candidates.push_back(static_cast<uint32_t>(l));
+					cx.push_back(m_lightX[l]);
+					cy.push_back(m_lightY[l]);
+					cz.push_back(m_lightZ[l]);
+					cr.push_back(m_lightRadius[l]);
+				}
+
+				std::vector<uint32_t>& indices = m_sliceIndices[k];
+				indices.clear();
+
+				for (size_t t = 0; t < tilesPerSlice; t++)
+				{
+					const ClusterBounds& bounds = m_clusterBounds[k * tilesPerSlice + t];
+					ClusterLightRange& range = m_clusters[k * tilesPerSlice + t];
+					range.offset = static_cast<uint32_t>(indices.size()); // Relative to the slice until merged
+					range.count = 0;
+
+					size_t c = 0;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+					const __m128 zero = _mm_setzero_ps();
+					const __m128 minX = _mm_set1_ps(bounds.minX), maxX = _mm_set1_ps(bounds.maxX);
+					const __m128 minY = _mm_set1_ps(bounds.minY), maxY = _mm_set1_ps(bounds.maxY);
+					const __m128 minZ = _mm_set1_ps(zNear), maxZ = _mm_set1_ps(zFar);
+
+					for (; c + 4 <= candidates.size() && range.count < maxLights; c += 4)
+					{
+						const __m128 x = _mm_loadu_ps(cx.data() + c);
+						const __m128 y = _mm_loadu_ps(cy.data() + c);
+						const __m128 z = _mm_loadu_ps(cz.data() + c);
+						const __m128 r = _mm_loadu_ps(cr.data() + c);
+
+						const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, x), zero), _mm_sub_ps(x, maxX));
+						const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, y), zero), _mm_sub_ps(y, maxY));
+						const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, z), zero), _mm_sub_ps(z, maxZ));
+						const __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+						const int hits = _mm_movemask_ps(_mm_cmple_ps(distanceSq, _mm_mul_ps(r, r)));
+						for (size_t lane = 0; lane < 4 && range.count < maxLights; lane++)
+						{
+							if (hits & (1 << lane))
+							{
+								indices.push_back(candidates[c + lane]);
+								range.count++;
+							}
+						}
+					}
+#endif
+
+					for (; c < candidates.size() && range.count < maxLights; c++)
+					{
+						if (SphereIntersectsBox(cx[c], cy[c], cz[c], cr[c], bounds.minX, bounds.minY, zNear, bounds.maxX, bounds.maxY, zFar))
+						{
+							indices.push_back(candidates[c]);
+							range.count++;
+						}
+					}
+				}
+			}
+		});
+
+		// Merge the slice lists into one compact list and rebase the cluster offsets
+		size_t total = 0;
+		for (const std::vector<uint32_t>& indices : m_sliceIndices)
+			total += indices.size();
+
+		m_lightIndices.resize(total);
+		uint32_t base = 0;
+		for (size_t k = 0; k < m_sliceIndices.size(); k++)
+		{
+			std::copy(m_sliceIndices[k].begin(), m_sliceIndices[k].end(), m_lightIndices.begin() + base);
+			for (size_t t = 0; t < tilesPerSlice; t++)
+				m_clusters[k * tilesPerSlice + t].offset += base;
+
+			base += static_cast<uint32_t>(m_sliceIndices[k].size());
+		}
+	}
+
+	float ClusteredLightBuilder::GetSliceScale() const noexcept
+	{
+		return static_cast<float>(m_settings.slicesZ) / std::log2(m_settings.farZ / m_settings.nearZ);
+	}
+
+	float ClusteredLightBuilder::GetSliceBias() const noexcept
+	{
+		return -static_cast<float>(m_settings.slicesZ) * std::log2(m_settings.nearZ) / std::log2(m_settings.farZ / m_settings.nearZ);
+	}
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <ClusteredLights.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	constexpr float VerticalFov = 1.04719755f; // 60 degrees
+	constexpr float AspectRatio = 16.0f / 9.0f;
+
+	struct Cluster
+	{
+		int x, y, z;
+	};
+
+	Light MakePointLight(const Math::Float3& position, float range)
+	{
+		Light light{};
+		light.position = position;
+		light.range = range;
+		light.type = LightType::Point;
+
+		return light;
+	}
+
+	Light MakeSpotLight(const Math::Float3& position, const Math::Float3& direction, float range, float cosOuterAngle)
+	{
+		Light light = MakePointLight(position, range);
+		light.type = LightType::Spot;
+		light.direction = direction;
+		light.spotCosOuterAngle = cosOuterAngle;
+		light.spotCosInnerAngle = cosOuterAngle;
+
+		return light;
+	}
+
+	class ClusteredLightsTests : public ::testing::Test
+	{
+	protected:
+		ClusterGridSettings m_settings;
+		ClusteredLightBuilder m_builder;
+
+		void SetUp() override
+		{
+			m_builder.Configure(m_settings, VerticalFov, AspectRatio);
+		}
+
+		// Cluster of a view space position, computed the way a shader does from the pixel and its depth
+		Cluster ClusterOf(const Math::Float3& position) const
+		{
+			const float tanHalfFovY = std::tan(VerticalFov * 0.5f);
+			const float ndcX = position.x / (position.z * tanHalfFovY * AspectRatio);
+			const float ndcY = position.y / (position.z * tanHalfFovY);
+
+			return Cluster{
+				static_cast<int>(std::floor((ndcX + 1.0f) * 0.5f * m_settings.tilesX)),
+				static_cast<int>(std::floor((1.0f - ndcY) * 0.5f * m_settings.tilesY)),
+				static_cast<int>(std::floor(std::log2(position.z) * m_builder.GetSliceScale() + m_builder.GetSliceBias()))
+			};
+		}
+
+		bool Contains(const Cluster& cluster, uint32_t light) const
+		{
+			const ClusterLightRange& range = m_builder.GetClusters()[cluster.x + cluster.y * m_settings.tilesX + size_t(cluster.z) * m_settings.tilesX * m_settings.tilesY];
+			for (uint32_t i = 0; i < range.count; i++)
+			{
+				if (m_builder.GetLightIndices()[range.offset + i] == light)
+					return true;
+			}
+
+			return false;
+		}
+
+		// Every cluster holding the light
+		std::vector<Cluster> ClustersWith(uint32_t light) const
+		{
+			std::vector<Cluster> clusters;
+			for (int z = 0; z < m_settings.slicesZ; z++)
+			{
+				for (int y = 0; y < m_settings.tilesY; y++)
+				{
+					for (int x = 0; x < m_settings.tilesX; x++)
+					{
+						if (Contains(Cluster{ x, y, z }, light))
+							clusters.push_back(Cluster{ x, y, z });
+					}
+				}
+			}
+
+			return clusters;
+		}
+
+		// Depth halfway, in log space, through a slice
+		float SliceCenterDepth(int slice) const
+		{
+			return m_settings.nearZ * std::pow(m_settings.farZ / m_settings.nearZ, (slice + 0.5f) / m_settings.slicesZ);
+		}
+	};
+}
+
+TEST_F(ClusteredLightsTests, SliceScaleAndBiasReproduceSliceBoundaries)
+{
+	for (int k = 0; k < m_settings.slicesZ; k++)
+	{
+		const float zNear = m_settings.nearZ * std::pow(m_settings.farZ / m_settings.nearZ, static_cast<float>(k) / m_settings.slicesZ);
+		const float zFar = m_settings.nearZ * std::pow(m_settings.farZ / m_settings.nearZ, static_cast<float>(k + 1) / m_settings.slicesZ);
+
+		EXPECT_EQ(ClusterOf({ 0.0f, 0.0f, zNear * 1.001f }).z, k) << "slice " << k;
+		EXPECT_EQ(ClusterOf({ 0.0f, 0.0f, SliceCenterDepth(k) }).z, k) << "slice " << k;
+		EXPECT_EQ(ClusterOf({ 0.0f, 0.0f, zFar * 0.999f }).z, k) << "slice " << k;
+	}
+
+	EXPECT_NEAR(std::log2(m_settings.nearZ) * m_builder.GetSliceScale() + m_builder.GetSliceBias(), 0.0f, 1e-4f);
+	EXPECT_NEAR(std::log2(m_settings.farZ) * m_builder.GetSliceScale() + m_builder.GetSliceBias(), static_cast<float>(m_settings.slicesZ), 1e-3f);
+}
+
+TEST_F(ClusteredLightsTests, PointLightsLandInTheirFroxel)
+{
+	const float tanHalfFovY = std::tan(VerticalFov * 0.5f);
+
+	// Tiny lights at the center of a spread of froxels
+	std::vector<Light> lights;
+	std::vector<Cluster> expected;
+	for (const Cluster cluster : { Cluster{ 0, 0, 3 }, Cluster{ 7, 4, 10 }, Cluster{ 15, 8, 23 }, Cluster{ 12, 2, 16 } })
+	{
+		const float z = SliceCenterDepth(cluster.z);
+		const float ndcX = -1.0f + (2.0f * cluster.x + 1.0f) / m_settings.tilesX;
+		const float ndcY = 1.0f - (2.0f * cluster.y + 1.0f) / m_settings.tilesY;
+		lights.push_back(MakePointLight({ ndcX * z * tanHalfFovY * AspectRatio, ndcY * z * tanHalfFovY, z }, z * 1e-4f));
+		expected.push_back(cluster);
+	}
+
+	m_builder.Build(lights.data(), lights.size(), Math::Float4x4::Identity);
+
+	for (uint32_t l = 0; l < lights.size(); l++)
+	{
+		const Cluster cluster = ClusterOf(lights[l].position);
+		EXPECT_EQ(cluster.x, expected[l].x);
+		EXPECT_EQ(cluster.y, expected[l].y);
+		EXPECT_EQ(cluster.z, expected[l].z);
+		EXPECT_TRUE(Contains(cluster, l)) << "light " << l;
+
+		// Cluster bounds are conservative boxes, so a light may also reach the neighbouring tiles of its slice, but nothing further
+		for (const Cluster& with : ClustersWith(l))
+		{
+			EXPECT_EQ(with.z, expected[l].z) << "light " << l;
+			EXPECT_LE(std::abs(with.x - expected[l].x), 1) << "light " << l;
+			EXPECT_LE(std::abs(with.y - expected[l].y), 1) << "light " << l;
+		}
+	}
+}
+
+TEST_F(ClusteredLightsTests, LightsAreBinnedInViewSpace)
+{
+	// Camera at (100, 0, -50) looking down +z, the light is 20 units straight ahead of it
+	Math::Float4x4 view = Math::Float4x4::Identity;
+	view.m[3][0] = -100.0f;
+	view.m[3][2] = 50.0f;
+
+	const Light light = MakePointLight({ 100.0f, 0.0f, -30.0f }, 0.5f);
+	m_builder.Build(&light, 1, view);
+
+	EXPECT_TRUE(Contains(ClusterOf({ 0.0f, 0.0f, 20.0f }), 0));
+	EXPECT_FALSE(ClustersWith(0).empty());
+	for (const Cluster& with : ClustersWith(0))
+		EXPECT_LE(std::abs(with.z - ClusterOf({ 0.0f, 0.0f, 20.0f }).z), 1);
+}
+
+TEST_F(ClusteredLightsTests, SpotLightsCoverTheirCone)
+{
+	// Lights shining across the view at a depth of 30
+	const Light lights[3] = {
+		MakeSpotLight({ -10.0f, 0.0f, 30.0f }, { 1.0f, 0.0f, 0.0f }, 40.0f, 0.95f),	// Narrow, bounded around the cone
+		MakeSpotLight({ -10.0f, 0.0f, 30.0f }, { 1.0f, 0.0f, 0.0f }, 40.0f, 0.5f),	// Wide, bounded around the apex
+		MakePointLight({ -10.0f, 0.0f, 30.0f }, 40.0f)
+	};
+	m_builder.Build(lights, 3, Math::Float4x4::Identity);
+
+	// Along the axis every light reaches
+	for (const float x : { -5.0f, 10.0f, 25.0f })
+	{
+		for (uint32_t l = 0; l < 3; l++)
+			EXPECT_TRUE(Contains(ClusterOf({ x, 0.0f, 30.0f }), l)) << "light " << l << " x " << x;
+	}
+
+	// Behind the apex only the lights bounded by the sphere around their position
+	const Cluster behind = ClusterOf({ -25.0f, 0.0f, 30.0f });
+	EXPECT_FALSE(Contains(behind, 0));
+	EXPECT_TRUE(Contains(behind, 1));
+	EXPECT_TRUE(Contains(behind, 2));
+
+	// In range of the apex but far outside the narrow cone
+	const Cluster side = ClusterOf({ 5.0f, 0.0f, 5.0f });
+	EXPECT_FALSE(Contains(side, 0));
+	EXPECT_TRUE(Contains(side, 2));
+
+	EXPECT_LT(ClustersWith(0).size(), ClustersWith(1).size());
+	EXPECT_EQ(ClustersWith(1).size(), ClustersWith(2).size());
+}
+
+TEST_F(ClusteredLightsTests, ClustersKeepTheFirstLightsPastTheCap)
+{
+	m_settings.maxLightsPerCluster = 5;
+	m_builder.Configure(m_settings, VerticalFov, AspectRatio);
+
+	std::vector<Light> lights(13, MakePointLight({ 0.0f, 0.0f, 10.0f }, 0.1f));
+	m_builder.Build(lights.data(), lights.size(), Math::Float4x4::Identity);
+
+	const Cluster cluster = ClusterOf({ 0.0f, 0.0f, 10.0f });
+	const ClusterLightRange& range = m_builder.GetClusters()[cluster.x + cluster.y * m_settings.tilesX + size_t(cluster.z) * m_settings.tilesX * m_settings.tilesY];
+	ASSERT_EQ(range.count, 5u);
+	for (uint32_t i = 0; i < range.count; i++)
+		EXPECT_EQ(m_builder.GetLightIndices()[range.offset + i], i);
+}
+
+TEST(ClusteredLightBuilder, RejectsInvalidGrid)
+{
+	ClusteredLightBuilder builder;
+	ClusterGridSettings settings;
+	settings.slicesZ = 0;
+	EXPECT_THROW(builder.Configure(settings, 1.0f, 1.0f), std::invalid_argument);
+
+	settings = ClusterGridSettings{};
+	settings.farZ = settings.nearZ;
+	EXPECT_THROW(builder.Configure(settings, 1.0f, 1.0f), std::invalid_argument);
+}
@@ -0,0 +1,77 @@
+#ifndef ULTREALITY_RENDERING_MESHLET_H
+#define ULTREALITY_RENDERING_MESHLET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// A bounded cluster of triangles consumed by a single mesh shader thread group
+	/// </summary>
+	struct Meshlet
+	{
+		uint32_t vertexOffset;		// Offset into MeshletMesh::vertexIndices of the meshlet's first vertex
+		uint32_t triangleOffset;	// Offset into MeshletMesh::primitiveIndices of the meshlet's first triangle (3 entries per triangle)
+		uint32_t vertexCount;
+		uint32_t triangleCount;
+	};
+
+	/// <summary>
+	/// Culling data of a meshlet, in the same space as the positions it was built from
+	/// </summary>
+	struct MeshletBounds
+	{
+		Math::Float3 center;	// Bounding sphere center
+		float radius;			// Bounding sphere radius
+		Math::Float3 coneAxis;	// Average facing direction of the meshlet's triangles
+		float coneCutoff;		// Sine of the normal cone's half angle. 1 when the cone is too wide to ever cull the meshlet
+	};
+
+	/// <summary>
+	/// An indexed mesh split into meshlets, laid out for upload as Structured buffers
+	/// </summary>
+	struct MeshletMesh
+	{
+		std::vector<Meshlet> meshlets;
+		std::vector<MeshletBounds> bounds;		// One entry per meshlet
+		std::vector<uint32_t> vertexIndices;	// Meshlet local vertex -> index into the source vertex buffer
+		std::vector<uint8_t> primitiveIndices;	// Meshlet local triangle list, indexes the meshlet's entries of vertexIndices
+	};
+
+	/// <summary>
+	/// Splits indexed triangle lists into meshlets for the <see cref="ShaderType::Mesh"/> stage
+	/// </summary>
+	class MeshletBuilder
+	{
+	public:
+		static constexpr size_t DefaultMaxVertices = 64;
+		static constexpr size_t DefaultMaxTriangles = 124;
+		static constexpr size_t MaxVerticesLimit = 256; // Local indices are stored in 8 bits
+
+		/// <summary>
+		/// Split an indexed triangle list into meshlets and compute their culling bounds
+		/// </summary>
+		/// <param name="positions">Pointer to the position of the first vertex</param>
+		/// <param name="vertexCount">Number of vertices</param>
+		/// <param name="positionStride">Number of bytes between consecutive positions, sizeof(Vertex) when pointing into a <see cref="Vertex"/> array</param>
+		/// <param name="indices">Triangle list indices</param>
+		/// <param name="indexCount">Number of indices, must be a multiple of 3</param>
+		/// <param name="maxVertices">Maximum number of unique vertices per meshlet</param>
+		/// <param name="maxTriangles">Maximum number of triangles per meshlet</param>
+		/// <returns>The meshlets, their bounds and their index data</returns>
+		/// <exception cref="std.invalid_argument">Thrown if the limits are out of range or indexCount is not a multiple of 3</exception>
+		/// <exception cref="std.out_of_range">Thrown if an index references a vertex past vertexCount</exception>
+		static MeshletMesh Build(const Math::Float3* positions, size_t vertexCount, size_t positionStride, const uint32_t* indices, size_t indexCount, size_t maxVertices = DefaultMaxVertices, size_t maxTriangles = DefaultMaxTriangles);
+
+		/// <summary>
+		/// Compute the bounding sphere and normal cone of a single meshlet
+		/// </summary>
+		static MeshletBounds ComputeBounds(const MeshletMesh& mesh, const Meshlet& meshlet, const Math::Float3* positions, size_t positionStride) noexcept;
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_MESHLET_H
@@ -0,0 +1,57 @@
+#ifndef ULTREALITY_RENDERING_MESHLET_CULLER_H
+#define ULTREALITY_RENDERING_MESHLET_CULLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <Frustum.h>
+#include <Meshlet.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// CPU cluster culling pass. Rejects meshlets outside the frustum or whose triangles all face away from the camera,
+	/// so only the surviving meshlets are dispatched to the mesh shader stage
+	/// </summary>
+	class MeshletCuller
+	{
+	protected:
+		// Bounds are kept as SoA so 4 meshlets are tested per SIMD iteration
+		std::vector<float> m_centerX;
+		std::vector<float> m_centerY;
+		std::vector<float> m_centerZ;
+		std::vector<float> m_radius;
+		std::vector<float> m_axisX;
+		std::vector<float> m_axisY;
+		std::vector<float> m_axisZ;
+		std::vector<float> m_cutoff;
+		std::vector<uint8_t> m_visible;
+
+	public:
+		/// <summary>
+		/// Set the meshlets the culler tests
+		/// </summary>
+		/// <param name="bounds">Bounds of each meshlet, typically <see cref="MeshletMesh::bounds"/></param>
+		void SetMeshlets(const std::vector<MeshletBounds>& bounds);
+
+		/// <summary>
+		/// Get the number of meshlets the culler tests
+		/// </summary>
+		size_t GetMeshletCount() const noexcept
+		{
+			return m_radius.size();
+		}
+
+		/// <summary>
+		/// Cull the meshlets in parallel. The frustum and camera must be in the same space as the meshlet bounds (object space, or transform the bounds)
+		/// </summary>
+		/// <param name="frustum">View frustum to test against</param>
+		/// <param name="cameraPosition">Position of the camera for the backface cone test</param>
+		/// <param name="visibleMeshlets">Output, cleared then filled with the indices of the visible meshlets in ascending order</param>
+		/// <returns>Number of visible meshlets</returns>
+		size_t Cull(const Frustum& frustum, const Math::Float3& cameraPosition, std::vector<uint32_t>& visibleMeshlets);
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_MESHLET_CULLER_H
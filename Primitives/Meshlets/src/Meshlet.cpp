@@ -0,0 +1,168 @@
+#include <Meshlet.h>
+#include <ParallelFor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		constexpr uint32_t UnusedLocalIndex = std::numeric_limits<uint32_t>::max();
+
+		// Meshlets per task when computing bounds
+		constexpr size_t BoundsGrainSize = 256;
+
+		inline const Math::Float3& PositionAt(const Math::Float3* positions, size_t stride, uint32_t index) noexcept
+		{
+			return *reinterpret_cast<const Math::Float3*>(reinterpret_cast<const uint8_t*>(positions) + stride * index);
+		}
+	}
+
+	MeshletMesh MeshletBuilder::Build(const Math::Float3* positions, size_t vertexCount, size_t positionStride, const uint32_t* indices, size_t indexCount, size_t maxVertices, size_t maxTriangles)
+	{
+		if (maxVertices < 3 || maxVertices > MaxVerticesLimit)
+			throw std::invalid_argument("Meshlet vertex limit must be in the range [3, 256]");
+		if (maxTriangles == 0)
+			throw std::invalid_argument("Meshlet triangle limit must be greater than 0");
+		if (indexCount % 3 != 0)
+			throw std::invalid_argument("Meshlet index count must be a multiple of 3");
+
+		MeshletMesh mesh;
+		const size_t triangleCount = indexCount / 3;
+		const size_t meshletEstimate = triangleCount / maxTriangles + 1;
+		mesh.meshlets.reserve(meshletEstimate);
+		mesh.vertexIndices.reserve(meshletEstimate * maxVertices);
+		mesh.primitiveIndices.reserve(indexCount);
+
+		// Maps source vertices to their local index in the meshlet being built
+		std::vector<uint32_t> localIndex(vertexCount, UnusedLocalIndex);
+
+		Meshlet current{ 0, 0, 0, 0 };
+		const auto flush = [&]()
+		{
+			if (current.triangleCount == 0)
+				return;
+
+			for (uint32_t i = 0; i < current.vertexCount; i++)
+				localIndex[mesh.vertexIndices[current.vertexOffset + i]] = UnusedLocalIndex;
+
+			mesh.meshlets.push_back(current);
+			current = Meshlet{ static_cast<uint32_t>(mesh.vertexIndices.size()), static_cast<uint32_t>(mesh.primitiveIndices.size()), 0, 0 };
+		};
+
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			const uint32_t a = indices[t * 3 + 0];
+			const uint32_t b = indices[t * 3 + 1];
+			const uint32_t c = indices[t * 3 + 2];
+			if (a >= vertexCount || b >= vertexCount || c >= vertexCount)
+				throw std::out_of_range("Meshlet index references a vertex past the end of the vertex buffer");
+
+			const uint32_t newVertices = (localIndex[a] == UnusedLocalIndex ? 1u : 0u)
+				+ (localIndex[b] == UnusedLocalIndex && b != a ? 1u : 0u)
+				+ (localIndex[c] == UnusedLocalIndex && c != a && c != b ? 1u : 0u);
+
+			if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles)
+				flush();
+
+			for (const uint32_t vertex : { a, b, c })
+			{
+				if (localIndex[vertex] == UnusedLocalIndex)
+				{
+					localIndex[vertex] = current.vertexCount++;
+					mesh.vertexIndices.push_back(vertex);
+				}
+
+				mesh.primitiveIndices.push_back(static_cast<uint8_t>(localIndex[vertex]));
+			}
+
+			current.triangleCount++;
+		}
+
+		flush();
+
+		mesh.bounds.resize(mesh.meshlets.size());
+		Parallel::ParallelFor(mesh.meshlets.size(), BoundsGrainSize, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				mesh.bounds[i] = ComputeBounds(mesh, mesh.meshlets[i], positions, positionStride);
+		});
+
+		return mesh;
+	}
+
+	MeshletBounds MeshletBuilder::ComputeBounds(const MeshletMesh& mesh, const Meshlet& meshlet, const Math::Float3* positions, size_t positionStride) noexcept
+	{
+		MeshletBounds bounds{ { 0.0f, 0.0f, 0.0f }, 0.0f, { 0.0f, 0.0f, 1.0f }, 1.0f };
+		if (meshlet.vertexCount == 0)
+			return bounds;
+
+		const uint32_t* vertices = mesh.vertexIndices.data() + meshlet.vertexOffset;
+
+		// Bounding sphere centered on the AABB
+		Math::Float3 minimum = PositionAt(positions, positionStride, vertices[0]);
+		Math::Float3 maximum = minimum;
+		for (uint32_t i = 1; i < meshlet.vertexCount; i++)
+		{
+			const Math::Float3& p = PositionAt(positions, positionStride, vertices[i]);
+			minimum = Math::Float3{ std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+			maximum = Math::Float3{ std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+		}
+
+		bounds.center = Math::Float3{ (minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f };
+
+		float radiusSq = 0.0f;
+		for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+		{
+			const Math::Float3& p = PositionAt(positions, positionStride, vertices[i]);
+			const float dx = p.x - bounds.center.x;
+			const float dy = p.y - bounds.center.y;
+			const float dz = p.z - bounds.center.z;
+			radiusSq = std::max(radiusSq, dx * dx + dy * dy + dz * dz);
+		}
+		bounds.radius = std::sqrt(radiusSq);
+
+		// Normal cone from the unit normals of the non-degenerate triangles
+		std::vector<Math::Float3> normals;
+		normals.reserve(meshlet.triangleCount);
+		Math::Float3 axis{ 0.0f, 0.0f, 0.0f };
+
+		const uint8_t* triangles = mesh.primitiveIndices.data() + meshlet.triangleOffset;
+		for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+		{
+			const Math::Float3& p0 = PositionAt(positions, positionStride, vertices[triangles[t * 3 + 0]]);
+			const Math::Float3& p1 = PositionAt(positions, positionStride, vertices[triangles[t * 3 + 1]]);
+			const Math::Float3& p2 = PositionAt(positions, positionStride, vertices[triangles[t * 3 + 2]]);
+
+			const Math::Float3 e0{ p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+			const Math::Float3 e1{ p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+			Math::Float3 n{ e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x };
+
+			const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+			if (length <= 0.0f)
+				continue;
+
+			n = Math::Float3{ n.x / length, n.y / length, n.z / length };
+			normals.push_back(n);
+			axis = Math::Float3{ axis.x + n.x, axis.y + n.y, axis.z + n.z };
+		}
+
+		const float axisLength = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+		if (normals.empty() || axisLength <= 0.0f)
+			return bounds;
+
+		bounds.coneAxis = Math::Float3{ axis.x / axisLength, axis.y / axisLength, axis.z / axisLength };
+
+		float minDot = 1.0f;
+		for (const Math::Float3& n : normals)
+			minDot = std::min(minDot, n.x * bounds.coneAxis.x + n.y * bounds.coneAxis.y + n.z * bounds.coneAxis.z);
+
+		// A cone wider than a hemisphere always has a triangle facing the camera
+		bounds.coneCutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+
+		return bounds;
+	}
+}
@@ -0,0 +1,92 @@
+#include <MeshletCuller.h>
+#include <ParallelFor.h>
+#include <RenderingSIMD.h>
+
+#include <cmath>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		// Meshlets per task. A multiple of the SIMD width so only the final task has a scalar tail
+		constexpr size_t CullGrainSize = 1024;
+
+		inline bool IsConeBackfacing(float dx, float dy, float dz, float axisX, float axisY, float axisZ, float cutoff, float radius) noexcept
+		{
+			// Every triangle faces away when the view direction lies within the cone's complement, padded by the sphere radius
+			const float d = dx * axisX + dy * axisY + dz * axisZ;
+			return d > cutoff * std::sqrt(dx * dx + dy * dy + dz * dz) + radius;
+		}
+	}
+
+	void MeshletCuller::SetMeshlets(const std::vector<MeshletBounds>& bounds)
+	{
+		const size_t count = bounds.size();
+		for (std::vector<float>* stream : { &m_centerX, &m_centerY, &m_centerZ, &m_radius, &m_axisX, &m_axisY, &m_axisZ, &m_cutoff })
+			stream->resize(count);
+		m_visible.resize(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			m_centerX[i] = bounds[i].center.x;
+			m_centerY[i] = bounds[i].center.y;
+			m_centerZ[i] = bounds[i].center.z;
+			m_radius[i] = bounds[i].radius;
+			m_axisX[i] = bounds[i].coneAxis.x;
+			m_axisY[i] = bounds[i].coneAxis.y;
+			m_axisZ[i] = bounds[i].coneAxis.z;
+			m_cutoff[i] = bounds[i].coneCutoff;
+		}
+	}
+
+	size_t MeshletCuller::Cull(const Frustum& frustum, const Math::Float3& cameraPosition, std::vector<uint32_t>& visibleMeshlets)
+	{
+		const size_t count = m_radius.size();
+
+		Parallel::ParallelFor(count, CullGrainSize, [&](size_t begin, size_t end)
+		{
+			frustum.CullSpheres(m_centerX.data() + begin, m_centerY.data() + begin, m_centerZ.data() + begin, m_radius.data() + begin, end - begin, m_visible.data() + begin);
+
+			size_t i = begin;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+			const __m128 camX = _mm_set1_ps(cameraPosition.x);
+			const __m128 camY = _mm_set1_ps(cameraPosition.y);
+			const __m128 camZ = _mm_set1_ps(cameraPosition.z);
+
+			for (; i + 4 <= end; i += 4)
+			{
+				const __m128 dx = _mm_sub_ps(_mm_loadu_ps(m_centerX.data() + i), camX);
+				const __m128 dy = _mm_sub_ps(_mm_loadu_ps(m_centerY.data() + i), camY);
+				const __m128 dz = _mm_sub_ps(_mm_loadu_ps(m_centerZ.data() + i), camZ);
+
+				const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(m_axisX.data() + i)), _mm_mul_ps(dy, _mm_loadu_ps(m_axisY.data() + i))), _mm_mul_ps(dz, _mm_loadu_ps(m_axisZ.data() + i)));
+				const __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+				const __m128 threshold = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m_cutoff.data() + i), distance), _mm_loadu_ps(m_radius.data() + i));
+
+				const int backfacing = _mm_movemask_ps(_mm_cmpgt_ps(d, threshold));
+				for (size_t lane = 0; lane < 4; lane++)
+				{
+					if (backfacing & (1 << lane))
+						m_visible[i + lane] = 0;
+				}
+			}
+#endif
+
+			for (; i < end; i++)
+			{
+				if (m_visible[i] && IsConeBackfacing(m_centerX[i] - cameraPosition.x, m_centerY[i] - cameraPosition.y, m_centerZ[i] - cameraPosition.z, m_axisX[i], m_axisY[i], m_axisZ[i], m_cutoff[i], m_radius[i]))
+					m_visible[i] = 0;
+			}
+		});
+
+		visibleMeshlets.clear();
+		for (size_t i = 0; i < count; i++)
+		{
+			if (m_visible[i])
+				visibleMeshlets.push_back(static_cast<uint32_t>(i));
+		}
+
+		return visibleMeshlets.size();
+	}
+}
@@ -0,0 +1,93 @@
+#ifndef ULTREALITY_RENDERING_MULTI_ADAPTER_SCHEDULER_H
+#define ULTREALITY_RENDERING_MULTI_ADAPTER_SCHEDULER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace UltReality::Rendering
+{
+	enum class MultiAdapterMode : uint8_t
+	{
+		Single,			// Every frame on the presenting adapter
+		AlternateFrame,	// Whole frames round robin across the adapters
+		SplitFrame		// Every adapter renders a band of rows of each frame, sized by its measured throughput
+	};
+
+	/// <summary>
+	/// Rows of the frame an adapter renders. When copyToPresenter is set the rows must be copied explicitly into the presenting adapter's
+	/// back buffer once rendered, adapters do not share memory
+	/// </summary>
+	struct AdapterRegion
+	{
+		uint32_t adapterID;	// AdapterDesc::localID of the adapter
+		uint16_t rowBegin;
+		uint16_t rowEnd;
+		bool copyToPresenter;
+	};
+
+	struct MultiAdapterFramePlan
+	{
+		uint64_t frameIndex;
+		uint32_t presenterID;
+		std::vector<AdapterRegion> regions; // One per participating adapter, ordered by rows
+	};
+
+	/// <summary>
+	/// Distributes frames across several adapters, identified by their AdapterDesc::localID
+	/// </summary>
+	class MultiAdapterScheduler
+	{
+	protected:
+		MultiAdapterMode m_mode = MultiAdapterMode::Single;
+		std::vector<uint32_t> m_adapters;
+		uint32_t m_presenter = 0;
+		uint16_t m_width = 0;
+		uint16_t m_height = 0;
+
+		// Split frame load balancing, parallel to m_adapters
+		std::vector<float> m_rowsPerMs;		// Smoothed measured throughput, 0 until the first timing
+		std::vector<uint16_t> m_rowCount;	// Rows assigned in the last plan
+		std::vector<float> m_share;			// Split frame planning scratch
+
+		MultiAdapterFramePlan m_plan;
+
+		size_t IndexOf(uint32_t adapterID) const noexcept;
+
+	public:
+		/// <summary>
+		/// Configure the adapters and the frame distribution. Resets the load balancing to equal shares
+		/// </summary>
+		/// <param name="mode">How frames are distributed</param>
+		/// <param name="adapterIDs">Participating adapters</param>
+		/// <param name="presenterID">Adapter that owns the output and presents</param>
+		/// <param name="width">Width of the frame</param>
+		/// <param name="height">Height of the frame</param>
+		/// <exception cref="std.invalid_argument">Thrown if there are no adapters, the presenter is not one of them, the frame is empty, or split frame rendering has fewer rows than adapters</exception>
+		void Configure(MultiAdapterMode mode, const std::vector<uint32_t>& adapterIDs, uint32_t presenterID, uint16_t width, uint16_t height);
+
+		/// <summary>
+		/// Get the configured distribution
+		/// </summary>
+		MultiAdapterMode GetMode() const noexcept
+		{
+			return m_mode;
+		}
+
+		/// <summary>
+		/// Plan which adapter renders which rows of a frame
+		/// </summary>
+		/// <param name="frameIndex">Monotonic frame counter</param>
+		/// <returns>The plan, valid until the next call. Has no regions if the scheduler has not been configured</returns>
+		const MultiAdapterFramePlan& PlanFrame(uint64_t frameIndex);
+
+		/// <summary>
+		/// Report how long an adapter took to render its region of the last planned frame. Split frame plans move rows towards faster adapters
+		/// </summary>
+		/// <param name="adapterID">AdapterDesc::localID of the adapter</param>
+		/// <param name="milliseconds">GPU time of the region, excluding the cross-adapter copy</param>
+		void ReportTiming(uint32_t adapterID, float milliseconds) noexcept;
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_MULTI_ADAPTER_SCHEDULER_H
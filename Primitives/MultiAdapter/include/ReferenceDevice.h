@@ -0,0 +1,124 @@
+#ifndef ULTREALITY_RENDERING_REFERENCE_DEVICE_H
+#define ULTREALITY_RENDERING_REFERENCE_DEVICE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <VectorTypes.h>
+
+#include <MultiAdapterScheduler.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// CPU stand-in for an adapter, used to exercise multi-adapter scheduling without several GPUs. Each device owns its back buffer
+	/// and only reaches another device's memory through an explicit <see cref="CopyRows"/>, like a cross-adapter copy
+	/// </summary>
+	class ReferenceDevice
+	{
+	protected:
+		uint32_t m_localID;
+		uint16_t m_width;
+		uint16_t m_height;
+		std::vector<Math::Float4> m_backBuffer;
+
+	public:
+		/// <param name="localID">Id the device is scheduled by, standing in for AdapterDesc::localID</param>
+		/// <param name="width">Width of the back buffer</param>
+		/// <param name="height">Height of the back buffer</param>
+		ReferenceDevice(uint32_t localID, uint16_t width, uint16_t height)
+			: m_localID(localID), m_width(width), m_height(height), m_backBuffer(size_t(width) * height)
+		{}
+
+		uint32_t GetLocalID() const noexcept
+		{
+			return m_localID;
+		}
+
+		const std::vector<Math::Float4>& GetBackBuffer() const noexcept
+		{
+			return m_backBuffer;
+		}
+
+		/// <summary>
+		/// Shade a band of rows of the back buffer on the calling thread
+		/// </summary>
+		/// <param name="shader">Callable returning the Math::Float4 color of (uint16_t x, uint16_t y)</param>
+		/// <returns>Time taken in milliseconds</returns>
+		template<typename Shader>
+		float RenderRows(uint16_t rowBegin, uint16_t rowEnd, Shader&& shader)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (uint16_t y = rowBegin; y < rowEnd; y++)
+			{
+				for (uint16_t x = 0; x < m_width; x++)
+					m_backBuffer[size_t(y) * m_width + x] = shader(x, y);
+			}
+
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		/// <summary>
+		/// Copy a band of rows from another device's back buffer into this one
+		/// </summary>
+		void CopyRows(const ReferenceDevice& source, uint16_t rowBegin, uint16_t rowEnd)
+		{
+			std::copy(source.m_backBuffer.begin() + size_t(rowBegin) * m_width, source.m_backBuffer.begin() + size_t(rowEnd) * m_width, m_backBuffer.begin() + size_t(rowBegin) * m_width);
+		}
+	};
+
+	/// <summary>
+	/// Run a planned frame on reference devices: every region renders concurrently on its own device thread, the timings are reported to
+	/// the scheduler, then the regions are copied to the presenting device
+	/// </summary>
+	/// <param name="plan">Plan from <see cref="MultiAdapterScheduler::PlanFrame"/></param>
+	/// <param name="devices">Devices whose local ids cover the plan's adapters</param>
+	/// <param name="scheduler">Scheduler that made the plan, receives the timings</param>
+	/// <param name="shader">Callable returning the Math::Float4 color of (uint16_t x, uint16_t y). Called from several threads at once</param>
+	/// <returns>The presenting device, holding the complete frame</returns>
+	/// <exception cref="std.invalid_argument">Thrown if an adapter of the plan has no device</exception>
+	template<typename Shader>
+	ReferenceDevice& ExecuteFramePlan(const MultiAdapterFramePlan& plan, std::vector<ReferenceDevice>& devices, MultiAdapterScheduler& scheduler, Shader&& shader)
+	{
+		const auto find = [&](uint32_t localID) -> ReferenceDevice&
+		{
+			for (ReferenceDevice& device : devices)
+			{
+				if (device.GetLocalID() == localID)
+					return device;
+			}
+
+			throw std::invalid_argument("Frame plan references an adapter without a reference device");
+		};
+
+		std::vector<ReferenceDevice*> targets;
+		for (const AdapterRegion& region : plan.regions)
+			targets.push_back(&find(region.adapterID));
+		ReferenceDevice& presenter = find(plan.presenterID);
+
+		std::vector<float> timings(plan.regions.size());
+		std::vector<std::thread> threads;
+		for (size_t r = 1; r < plan.regions.size(); r++)
+			threads.emplace_back([&, r] { timings[r] = targets[r]->RenderRows(plan.regions[r].rowBegin, plan.regions[r].rowEnd, shader); });
+		if (!plan.regions.empty())
+			timings[0] = targets[0]->RenderRows(plan.regions[0].rowBegin, plan.regions[0].rowEnd, shader);
+		for (std::thread& thread : threads)
+			thread.join();
+
+		for (size_t r = 0; r < plan.regions.size(); r++)
+		{
+			scheduler.ReportTiming(plan.regions[r].adapterID, timings[r]);
+			if (plan.regions[r].copyToPresenter)
+				presenter.CopyRows(*targets[r], plan.regions[r].rowBegin, plan.regions[r].rowEnd);
+		}
+
+		return presenter;
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_REFERENCE_DEVICE_H
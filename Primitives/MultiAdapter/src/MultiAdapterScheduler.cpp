@@ -0,0 +1,113 @@
+#include <MultiAdapterScheduler.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		// Weight of a new timing in the throughput average, low enough that one slow frame does not move the split
+		constexpr float ThroughputSmoothing = 0.2f;
+
+		// Smallest share of the rows an adapter keeps, so its throughput is still measured
+		constexpr float MinimumShare = 0.05f;
+	}
+
+	size_t MultiAdapterScheduler::IndexOf(uint32_t adapterID) const noexcept
+	{
+		return static_cast<size_t>(std::find(m_adapters.begin(), m_adapters.end(), adapterID) - m_adapters.begin());
+	}
+
+	void MultiAdapterScheduler::Configure(MultiAdapterMode mode, const std::vector<uint32_t>& adapterIDs, uint32_t presenterID, uint16_t width, uint16_t height)
+	{
+		if (adapterIDs.empty())
+			throw std::invalid_argument("Multi-adapter scheduling needs at least one adapter");
+		if (std::find(adapterIDs.begin(), adapterIDs.end(), presenterID) == adapterIDs.end())
+			throw std::invalid_argument("Presenting adapter must be one of the scheduled adapters");
+		if (width == 0 || height == 0)
+			throw std::invalid_argument("Frame size must be greater than 0");
+		if (mode == MultiAdapterMode::SplitFrame && height < adapterIDs.size())
+			throw std::invalid_argument("Split frame rendering needs at least one row per adapter");
+
+		m_mode = adapterIDs.size() > 1 ? mode : MultiAdapterMode::Single;
+		m_adapters = adapterIDs;
+		m_presenter = presenterID;
+		m_width = width;
+		m_height = height;
+		m_rowsPerMs.assign(m_adapters.size(), 0.0f);
+		m_rowCount.assign(m_adapters.size(), 0);
+	}
+
+	const MultiAdapterFramePlan& MultiAdapterScheduler::PlanFrame(uint64_t frameIndex)
+	{
+		m_plan.frameIndex = frameIndex;
+		m_plan.presenterID = m_presenter;
+		m_plan.regions.clear();
+		std::fill(m_rowCount.begin(), m_rowCount.end(), uint16_t(0));
+
+		// Nothing to schedule until Configure has provided the adapters
+		if (m_adapters.empty())
+			return m_plan;
+
+		switch (m_mode)
+		{
+		case MultiAdapterMode::Single:
+			m_plan.regions.push_back(AdapterRegion{ m_presenter, 0, m_height, false });
+			m_rowCount[IndexOf(m_presenter)] = m_height;
+			break;
+		case MultiAdapterMode::AlternateFrame:
+		{
+			const size_t adapter = frameIndex % m_adapters.size();
+			m_plan.regions.push_back(AdapterRegion{ m_adapters[adapter], 0, m_height, m_adapters[adapter] != m_presenter });
+			m_rowCount[adapter] = m_height;
+			break;
+		}
+		case MultiAdapterMode::SplitFrame:
+		{
+			// Equal shares until every adapter has been measured
+			const size_t adapterCount = m_adapters.size();
+			const bool measured = std::find(m_rowsPerMs.begin(), m_rowsPerMs.end(), 0.0f) == m_rowsPerMs.end();
+			float total = 0.0f;
+			for (float rate : m_rowsPerMs)
+				total += rate;
+
+			// Shares proportional to throughput so every adapter finishes at the same time, raised to the minimum and renormalized
+			m_share.resize(adapterCount);
+			float shareTotal = 0.0f;
+			for (size_t a = 0; a < adapterCount; a++)
+			{
+				m_share[a] = measured ? std::max(m_rowsPerMs[a] / total, MinimumShare) : 1.0f;
+				shareTotal += m_share[a];
+			}
+
+			// Every adapter keeps at least one row so its throughput is still measured
+			uint16_t row = 0;
+			for (size_t a = 0; a < adapterCount; a++)
+			{
+				const float reserved = static_cast<float>(adapterCount - a - 1);
+				const uint16_t rows = a + 1 == adapterCount
+					? static_cast<uint16_t>(m_height - row)
+					: static_cast<uint16_t>(std::clamp<float>(m_share[a] / shareTotal * m_height + 0.5f, 1.0f, m_height - row - reserved));
+
+				m_plan.regions.push_back(AdapterRegion{ m_adapters[a], row, static_cast<uint16_t>(row + rows), m_adapters[a] != m_presenter });
+				m_rowCount[a] = rows;
+				row = static_cast<uint16_t>(row + rows);
+			}
+			break;
+		}
+		}
+
+		return m_plan;
+	}
+
+	void MultiAdapterScheduler::ReportTiming(uint32_t adapterID, float milliseconds) noexcept
+	{
+		const size_t adapter = IndexOf(adapterID);
+		if (adapter == m_adapters.size() || m_rowCount[adapter] == 0 || milliseconds <= 0.0f)
+			return;
+
+		const float rate = m_rowCount[adapter] / milliseconds;
+		m_rowsPerMs[adapter] = m_rowsPerMs[adapter] > 0.0f ? m_rowsPerMs[adapter] + ThroughputSmoothing * (rate - m_rowsPerMs[adapter]) : rate;
+	}
+}
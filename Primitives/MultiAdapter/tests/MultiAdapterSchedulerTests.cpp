@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <MultiAdapterScheduler.h>
+#include <ReferenceDevice.h>
+
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	constexpr uint16_t Width = 48;
+	constexpr uint16_t Height = 37;
+
+	Math::Float4 Shade(uint16_t x, uint16_t y)
+	{
+		return Math::Float4{ static_cast<float>(x), static_cast<float>(y), static_cast<float>(x ^ y), 1.0f };
+	}
+
+	std::vector<ReferenceDevice> MakeDevices(const std::vector<uint32_t>& ids)
+	{
+		std::vector<ReferenceDevice> devices;
+		for (uint32_t id : ids)
+			devices.emplace_back(id, Width, Height);
+
+		return devices;
+	}
+
+	void ExpectFullFrame(const ReferenceDevice& presenter)
+	{
+		ReferenceDevice single(presenter.GetLocalID(), Width, Height);
+		single.RenderRows(0, Height, Shade);
+
+		const std::vector<Math::Float4>& expected = single.GetBackBuffer();
+		const std::vector<Math::Float4>& actual = presenter.GetBackBuffer();
+		ASSERT_EQ(actual.size(), expected.size());
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			ASSERT_EQ(actual[i].x, expected[i].x) << "pixel " << i;
+			ASSERT_EQ(actual[i].y, expected[i].y) << "pixel " << i;
+			ASSERT_EQ(actual[i].z, expected[i].z) << "pixel " << i;
+			ASSERT_EQ(actual[i].w, expected[i].w) << "pixel " << i;
+		}
+	}
+
+	void ExpectRowsCoverFrame(const MultiAdapterFramePlan& plan, const std::vector<uint32_t>& ids)
+	{
+		ASSERT_EQ(plan.regions.size(), ids.size());
+
+		uint16_t row = 0;
+		for (size_t r = 0; r < plan.regions.size(); r++)
+		{
+			EXPECT_EQ(plan.regions[r].adapterID, ids[r]);
+			EXPECT_EQ(plan.regions[r].rowBegin, row);
+			EXPECT_GE(plan.regions[r].rowEnd, plan.regions[r].rowBegin + 1) << "adapter " << ids[r] << " has no rows";
+			EXPECT_EQ(plan.regions[r].copyToPresenter, ids[r] != plan.presenterID);
+			row = plan.regions[r].rowEnd;
+		}
+		EXPECT_EQ(row, Height);
+	}
+}
+
+TEST(MultiAdapterScheduler, UnconfiguredPlanIsEmpty)
+{
+	MultiAdapterScheduler scheduler;
+	EXPECT_TRUE(scheduler.PlanFrame(0).regions.empty());
+	scheduler.ReportTiming(0, 1.0f);
+	EXPECT_TRUE(scheduler.PlanFrame(1).regions.empty());
+}
+
+TEST(MultiAdapterScheduler, RejectsInvalidConfiguration)
+{
+	MultiAdapterScheduler scheduler;
+	EXPECT_THROW(scheduler.Configure(MultiAdapterMode::SplitFrame, {}, 0, Width, Height), std::invalid_argument);
+	EXPECT_THROW(scheduler.Configure(MultiAdapterMode::SplitFrame, { 0, 1 }, 2, Width, Height), std::invalid_argument);
+	EXPECT_THROW(scheduler.Configure(MultiAdapterMode::SplitFrame, { 0, 1 }, 0, Width, 0), std::invalid_argument);
+	EXPECT_THROW(scheduler.Configure(MultiAdapterMode::SplitFrame, { 0, 1, 2 }, 0, Width, 2), std::invalid_argument);
+}
+
+TEST(MultiAdapterScheduler, AlternateFrameRoundRobins)
+{
+	const std::vector<uint32_t> ids = { 7, 3, 9 };
+	MultiAdapterScheduler scheduler;
+	scheduler.Configure(MultiAdapterMode::AlternateFrame, ids, 3, Width, Height);
+	std::vector<ReferenceDevice> devices = MakeDevices(ids);
+
+	for (uint64_t frame = 0; frame < 9; frame++)
+	{
+		const MultiAdapterFramePlan& plan = scheduler.PlanFrame(frame);
+		ASSERT_EQ(plan.regions.size(), 1u);
+		EXPECT_EQ(plan.frameIndex, frame);
+		EXPECT_EQ(plan.presenterID, 3u);
+		EXPECT_EQ(plan.regions[0].adapterID, ids[frame % ids.size()]);
+		EXPECT_EQ(plan.regions[0].rowBegin, 0);
+		EXPECT_EQ(plan.regions[0].rowEnd, Height);
+		EXPECT_EQ(plan.regions[0].copyToPresenter, plan.regions[0].adapterID != 3u);
+
+		ReferenceDevice& presenter = ExecuteFramePlan(plan, devices, scheduler, Shade);
+		EXPECT_EQ(presenter.GetLocalID(), 3u);
+		ExpectFullFrame(presenter);
+	}
+}
+
+TEST(MultiAdapterScheduler, SingleAdapterFallsBackToSingleMode)
+{
+	MultiAdapterScheduler scheduler;
+	scheduler.Configure(MultiAdapterMode::SplitFrame, { 4 }, 4, Width, Height);
+	EXPECT_EQ(scheduler.GetMode(), MultiAdapterMode::Single);
+
+	const MultiAdapterFramePlan& plan = scheduler.PlanFrame(0);
+	ExpectRowsCoverFrame(plan, { 4 });
+}
+
+TEST(MultiAdapterScheduler, SplitFrameRowsCoverFrame)
+{
+	const std::vector<uint32_t> ids = { 0, 1, 2 };
+	MultiAdapterScheduler scheduler;
+	scheduler.Configure(MultiAdapterMode::SplitFrame, ids, 1, Width, Height);
+
+	// Equal shares before any timing is reported
+	const MultiAdapterFramePlan& first = scheduler.PlanFrame(0);
+	ExpectRowsCoverFrame(first, ids);
+	for (const AdapterRegion& region : first.regions)
+		EXPECT_NEAR(region.rowEnd - region.rowBegin, Height / 3.0f, 1.0f);
+
+	// An adapter reporting a huge cost still keeps a row
+	for (uint64_t frame = 1; frame < 50; frame++)
+	{
+		const MultiAdapterFramePlan& plan = scheduler.PlanFrame(frame);
+		ExpectRowsCoverFrame(plan, ids);
+		for (const AdapterRegion& region : plan.regions)
+			scheduler.ReportTiming(region.adapterID, (region.rowEnd - region.rowBegin) * (region.adapterID == 2 ? 1000.0f : 1.0f));
+	}
+	const MultiAdapterFramePlan& skewed = scheduler.PlanFrame(50);
+	ExpectRowsCoverFrame(skewed, ids);
+	EXPECT_LE(skewed.regions[2].rowEnd - skewed.regions[2].rowBegin, 2);
+}
+
+TEST(MultiAdapterScheduler, SplitFrameMovesRowsToFasterAdapter)
+{
+	const std::vector<uint32_t> ids = { 0, 1 };
+	MultiAdapterScheduler scheduler;
+	scheduler.Configure(MultiAdapterMode::SplitFrame, ids, 0, Width, 300);
+
+	// Adapter 1 renders rows twice as fast, so it should converge to two thirds of the frame
+	int previousRows = 0;
+	for (uint64_t frame = 0; frame < 40; frame++)
+	{
+		const MultiAdapterFramePlan& plan = scheduler.PlanFrame(frame);
+		const int fastRows = plan.regions[1].rowEnd - plan.regions[1].rowBegin;
+		EXPECT_GE(fastRows, previousRows) << "frame " << frame;
+		previousRows = fastRows;
+
+		scheduler.ReportTiming(0, (plan.regions[0].rowEnd - plan.regions[0].rowBegin) * 0.02f);
+		scheduler.ReportTiming(1, (plan.regions[1].rowEnd - plan.regions[1].rowBegin) * 0.01f);
+	}
+	EXPECT_NEAR(previousRows, 200, 2);
+}
+
+TEST(MultiAdapterScheduler, SplitFramePresenterMatchesSingleDevice)
+{
+	const std::vector<uint32_t> ids = { 5, 6, 8 };
+	MultiAdapterScheduler scheduler;
+	scheduler.Configure(MultiAdapterMode::SplitFrame, ids, 6, Width, Height);
+	std::vector<ReferenceDevice> devices = MakeDevices(ids);
+
+	for (uint64_t frame = 0; frame < 4; frame++)
+	{
+		ReferenceDevice& presenter = ExecuteFramePlan(scheduler.PlanFrame(frame), devices, scheduler, Shade);
+		EXPECT_EQ(presenter.GetLocalID(), 6u);
+		ExpectFullFrame(presenter);
+	}
+
+	// A device missing from the plan's adapters is reported
+	std::vector<ReferenceDevice> missing = MakeDevices({ 5, 6 });
+	EXPECT_THROW(ExecuteFramePlan(scheduler.PlanFrame(4), missing, scheduler, Shade), std::invalid_argument);
+}
@@ -0,0 +1,135 @@
+#ifndef ULTREALITY_RENDERING_POST_PROCESS_CHAIN_H
+#define ULTREALITY_RENDERING_POST_PROCESS_CHAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <VectorTypes.h>
+
+#include <Primitives.h>
+
+namespace UltReality::Rendering
+{
+	struct PostProcessSettings
+	{
+		bool bloom = false;
+		float bloomIntensity = 0.5f;		// Scale of the bloom added to the scene
+		float bloomThreshold = 1.0f;		// Brightness above which pixels bloom
+		float bloomKnee = 0.5f;				// Width of the soft transition around the threshold
+		uint8_t bloomLevels = 5;			// Levels of the mip chain the bloom spreads over
+
+		bool depthOfField = false;
+		float focusDistance = 10.0f;		// View depth in focus
+		float focusRange = 5.0f;			// Distance from the focus plane at which the blur reaches maxBlurRadius
+		float maxBlurRadius = 8.0f;			// Largest circle of confusion radius, in full resolution pixels
+
+		bool motionBlur = false;
+		float motionBlurScale = 0.5f;		// Fraction of the frame's motion the exposure smears over
+		uint8_t motionBlurSamples = 8;
+	};
+
+	enum class PostProcessPassType : uint8_t
+	{
+		Downsample,	// Filter the source into the next level of the shared chain. The first pass also computes the circle of confusion and the bloom threshold
+		Upsample,	// Accumulate bloom from a coarser level into a finer one
+		Composite	// Full resolution pass applying depth of field, motion blur and bloom together
+	};
+
+	struct PostProcessPass
+	{
+		static constexpr uint8_t SceneColor = 0xFF; // Level index standing for the full resolution input or output
+
+		PostProcessPassType type;
+		uint8_t sourceLevel;	// Chain level read, SceneColor for the input frame
+		uint8_t targetLevel;	// Chain level written, SceneColor for the output frame
+		uint16_t width;			// Size of the target
+		uint16_t height;
+	};
+
+	/// <summary>
+	/// Post-processing pipeline that merges the enabled effects into as few full-screen passes as possible. Bloom and depth of field share one
+	/// half resolution downsample chain whose passes filter both in a single read of each level, bloom is accumulated back up the chain,
+	/// and a single full resolution composite applies every effect.
+	/// Execute is the CPU reference, processing each pass in tiles spread across the cores with one pixel per SIMD register
+	/// </summary>
+	class PostProcessChain
+	{
+	protected:
+		PostProcessSettings m_settings;
+		uint16_t m_width = 0;
+		uint16_t m_height = 0;
+		std::vector<PostProcessPass> m_passes;
+
+		// Shared chain, level 0 is half resolution. rgb is the scene color, a is the largest near field circle of confusion in the footprint
+		std::vector<std::vector<Math::Float4>> m_levels;
+		// Thresholded bloom chain, same sizes as m_levels. Filled by the same downsample passes, then accumulated back up in place
+		std::vector<std::vector<Math::Float4>> m_bloom;
+		std::vector<Rectangle> m_levelSizes;
+
+		void Downsample(size_t level, const Math::Float4* color, const float* depth);
+		void Upsample(size_t level);
+		void Composite(const Math::Float4* color, const float* depth, const float* motion, Math::Float4* output);
+
+	public:
+		/// <summary>
+		/// Configure the pipeline, plan its passes and allocate the mip chain
+		/// </summary>
+		/// <param name="settings">Effects to apply</param>
+		/// <param name="width">Width of the frame</param>
+		/// <param name="height">Height of the frame</param>
+		/// <exception cref="std.invalid_argument">Thrown if a dimension is 0 or an enabled effect has invalid parameters</exception>
+		void Configure(const PostProcessSettings& settings, uint16_t width, uint16_t height);
+
+		/// <summary>
+		/// Get the settings the pipeline was configured with
+		/// </summary>
+		const PostProcessSettings& GetSettings() const noexcept
+		{
+			return m_settings;
+		}
+
+		/// <summary>
+		/// Get the planned passes in execution order. Empty if no effect is enabled
+		/// </summary>
+		const std::vector<PostProcessPass>& GetPasses() const noexcept
+		{
+			return m_passes;
+		}
+
+		/// <summary>
+		/// Get the number of levels in the shared mip chain
+		/// </summary>
+		size_t GetLevelCount() const noexcept
+		{
+			return m_levels.size();
+		}
+
+		/// <summary>
+		/// Get a level of the shared mip chain as written by the last <see cref="Execute"/>
+		/// </summary>
+		const std::vector<Math::Float4>& GetLevel(size_t level) const noexcept
+		{
+			return m_levels[level];
+		}
+
+		/// <summary>
+		/// Get the size of a level of the shared mip chain
+		/// </summary>
+		const Rectangle& GetLevelSize(size_t level) const noexcept
+		{
+			return m_levelSizes[level];
+		}
+
+		/// <summary>
+		/// Run the planned passes on the CPU
+		/// </summary>
+		/// <param name="color">Linear HDR scene color, row major</param>
+		/// <param name="depth">Linear view depth per pixel. Only read when depth of field is enabled</param>
+		/// <param name="motion">Per pixel UV offset (2 floats) from the current to the previous frame's position. Only read when motion blur is enabled</param>
+		/// <param name="output">Destination, row major. May not alias the inputs. Receives a copy of color if no effect is enabled</param>
+		void Execute(const Math::Float4* color, const float* depth, const float* motion, Math::Float4* output);
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_POST_PROCESS_CHAIN_H
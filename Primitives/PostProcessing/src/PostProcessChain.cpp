@@ -0,0 +1,310 @@
+#include <PostProcessChain.h>
+#include <ParallelFor.h>
+#include <PixelSIMD.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace UltReality::Rendering
+{
+	using SIMD::Pixel;
+
+	namespace
+	{
+		constexpr int TileSize = 32; // Width and height of the pixel blocks handed to each task
+
+		/// Invoke func(x0, y0, x1, y1) for each tile of an image in parallel
+		template<typename Func>
+		void ForEachTile(int width, int height, Func&& func)
+		{
+			const int tilesX = (width + TileSize - 1) / TileSize;
+			const int tilesY = (height + TileSize - 1) / TileSize;
+
+			Parallel::ParallelFor(size_t(tilesX) * tilesY, 1, [&](size_t begin, size_t end)
+			{
+				for (size_t tile = begin; tile < end; tile++)
+				{
+					const int x0 = static_cast<int>(tile % tilesX) * TileSize;
+					const int y0 = static_cast<int>(tile / tilesX) * TileSize;
+					func(x0, y0, std::min(x0 + TileSize, width), std::min(y0 + TileSize, height));
+				}
+			});
+		}
+
+		/// Keep the part of a color above the bloom threshold, with a quadratic knee so the cut off does not alias
+		inline Pixel Threshold(Pixel color, float threshold, float knee) noexcept
+		{
+			Math::Float4 c;
+			color.Store(c);
+			const float brightness = std::max({ c.x, c.y, c.z });
+			const float soft = std::clamp(brightness - threshold + knee, 0.0f, 2.0f * knee);
+			const float contribution = std::max(soft * soft / (4.0f * knee + 1e-5f), brightness - threshold) / std::max(brightness, 1e-5f);
+
+			return color * Pixel::Splat(contribution);
+		}
+	}
+
+	void PostProcessChain::Configure(const PostProcessSettings& settings, uint16_t width, uint16_t height)
+	{
+		if (width == 0 || height == 0)
+			throw std::invalid_argument("Post-processing resolution must be greater than 0");
+		if (settings.depthOfField && (settings.focusRange <= 0.0f || settings.maxBlurRadius <= 0.0f))
+			throw std::invalid_argument("Depth of field focus range and blur radius must be greater than 0");
+		if (settings.bloom && settings.bloomLevels == 0)
+			throw std::invalid_argument("Bloom needs at least one mip level");
+
+		m_settings = settings;
+		m_width = width;
+		m_height = height;
+		m_passes.clear();
+
+		// Level k is 2^(k + 1) times smaller than the frame, so depth of field needs enough levels for a footprint of maxBlurRadius.
+		// Radii below 2 pixels still get one level
+		size_t levelCount = 0;
+		if (settings.bloom)
+			levelCount = settings.bloomLevels;
+		if (settings.depthOfField)
+			levelCount = std::max(levelCount, static_cast<size_t>(std::max(std::ceil(std::log2(settings.maxBlurRadius)), 1.0f)));
+
+		// The first level is always built, even for a 1x1 frame, so bloom and depth of field have a level to read
+		m_levelSizes.clear();
+		Rectangle size{ width, height };
+		for (size_t level = 0; level < levelCount && (level == 0 || size.width > 1 || size.height > 1); level++)
+		{
+			size = Rectangle{ static_cast<uint16_t>((size.width + 1) / 2), static_cast<uint16_t>((size.height + 1) / 2) };
+			m_levelSizes.push_back(size);
+		}
+
+		m_levels.resize(m_levelSizes.size());
+		m_bloom.resize(settings.bloom ? m_levelSizes.size() : 0);
+		for (size_t level = 0; level < m_levelSizes.size(); level++)
+		{
+			const size_t pixelCount = size_t(m_levelSizes[level].width) * m_levelSizes[level].height;
+			m_levels[level].resize(pixelCount);
+			if (settings.bloom)
+				m_bloom[level].resize(pixelCount);
+		}
+
+		if (!settings.bloom && !settings.depthOfField && !settings.motionBlur)
+			return;
+
+		for (size_t level = 0; level < m_levelSizes.size(); level++)
+			m_passes.push_back(PostProcessPass{ PostProcessPassType::Downsample, level ? static_cast<uint8_t>(level - 1) : PostProcessPass::SceneColor, static_cast<uint8_t>(level), m_levelSizes[level].width, m_levelSizes[level].height });
+
+		// Bloom is accumulated back up the chain, the coarsest level is only read
+		if (settings.bloom)
+		{
+			for (size_t level = m_levelSizes.size() - 1; level-- > 0;)
+				m_passes.push_back(PostProcessPass{ PostProcessPassType::Upsample, static_cast<uint8_t>(level + 1), static_cast<uint8_t>(level), m_levelSizes[level].width, m_levelSizes[level].height });
+		}
+
+		m_passes.push_back(PostProcessPass{ PostProcessPassType::Composite, PostProcessPass::SceneColor, PostProcessPass::SceneColor, width, height });
+	}
+
+	void PostProcessChain::Downsample(size_t level, const Math::Float4* color, const float* depth)
+	{
+		const int sourceWidth = level ? m_levelSizes[level - 1].width : m_width;
+		const int sourceHeight = level ? m_levelSizes[level - 1].height : m_height;
+		const Math::Float4* source = level ? m_levels[level - 1].data() : color;
+		Math::Float4* target = m_levels[level].data();
+		const int targetWidth = m_levelSizes[level].width;
+
+		const bool bloom = m_settings.bloom;
+		const Math::Float4* bloomSource = bloom && level ? m_bloom[level - 1].data() : nullptr;
+		Math::Float4* bloomTarget = bloom ? m_bloom[level].data() : nullptr;
+
+		const bool depthOfField = m_settings.depthOfField;
+		const float focusDistance = m_settings.focusDistance;
+		const float cocScale = m_settings.maxBlurRadius / m_settings.focusRange;
+		const float maxBlurRadius = m_settings.maxBlurRadius;
+
+		ForEachTile(targetWidth, m_levelSizes[level].height, [&](int x0, int y0, int x1, int y1)
+		{
+			const Pixel quarter = Pixel::Splat(0.25f);
+
+			for (int y = y0; y < y1; y++)
+			{
+				const size_t row0 = size_t(std::min(2 * y, sourceHeight - 1)) * sourceWidth;
+				const size_t row1 = size_t(std::min(2 * y + 1, sourceHeight - 1)) * sourceWidth;
+				for (int x = x0; x < x1; x++)
+				{
+					const size_t taps[4] = { row0 + std::min(2 * x, sourceWidth - 1), row0 + std::min(2 * x + 1, sourceWidth - 1), row1 + std::min(2 * x, sourceWidth - 1), row1 + std::min(2 * x + 1, sourceWidth - 1) };
+					const size_t index = size_t(y) * targetWidth + x;
+
+					const Pixel average = (Pixel::Load(source[taps[0]]) + Pixel::Load(source[taps[1]]) + Pixel::Load(source[taps[2]]) + Pixel::Load(source[taps[3]])) * quarter;
+
+					// The bloom chain is filtered by the same pass, the first level thresholds the scene it already has in registers
+					if (bloomTarget)
+					{
+						if (bloomSource)
+							((Pixel::Load(bloomSource[taps[0]]) + Pixel::Load(bloomSource[taps[1]]) + Pixel::Load(bloomSource[taps[2]]) + Pixel::Load(bloomSource[taps[3]])) * quarter).Store(bloomTarget[index]);
+						else
+							Threshold(average, m_settings.bloomThreshold, m_settings.bloomKnee).Store(bloomTarget[index]);
+					}
+
+					// Foreground blur spreads over the sharp background behind it, so track the largest near field circle of confusion
+					float nearCoC = 0.0f;
+					for (size_t tap : taps)
+					{
+						if (level)
+							nearCoC = std::max(nearCoC, source[tap].w);
+						else if (depthOfField)
+							nearCoC = std::max(nearCoC, std::min((focusDistance - depth[tap]) * cocScale, maxBlurRadius));
+					}
+
+					Math::Float4& out = target[index];
+					average.Store(out);
+					out.w = nearCoC;
+				}
+			}
+		});
+	}
+
+	void PostProcessChain::Upsample(size_t level)
+	{
+		const Math::Float4* coarseImage = m_bloom[level + 1].data();
+		const int coarseWidth = m_levelSizes[level + 1].width;
+		const int coarseHeight = m_levelSizes[level + 1].height;
+		const int targetWidth = m_levelSizes[level].width;
+		const int targetHeight = m_levelSizes[level].height;
+		Math::Float4* target = m_bloom[level].data();
+
+		const float scaleX = static_cast<float>(coarseWidth) / targetWidth;
+		const float scaleY = static_cast<float>(coarseHeight) / targetHeight;
+
+		ForEachTile(targetWidth, targetHeight, [&](int x0, int y0, int x1, int y1)
+		{
+			const Pixel quarter = Pixel::Splat(0.25f);
+
+			for (int y = y0; y < y1; y++)
+			{
+				const float cy = (static_cast<float>(y) + 0.5f) * scaleY - 0.5f;
+				for (int x = x0; x < x1; x++)
+				{
+					const float cx = (static_cast<float>(x) + 0.5f) * scaleX - 0.5f;
+
+					// Four bilinear taps half a texel apart approximate a 3x3 tent filter over the coarse level
+					const Pixel blurred = (SIMD::SampleBilinear(coarseImage, coarseWidth, coarseHeight, cx - 0.5f, cy - 0.5f)
+						+ SIMD::SampleBilinear(coarseImage, coarseWidth, coarseHeight, cx + 0.5f, cy - 0.5f)
+						+ SIMD::SampleBilinear(coarseImage, coarseWidth, coarseHeight, cx - 0.5f, cy + 0.5f)
+						+ SIMD::SampleBilinear(coarseImage, coarseWidth, coarseHeight, cx + 0.5f, cy + 0.5f)) * quarter;
+
+					// In place, each pixel only reads its own downsampled value from this level
+					const size_t index = size_t(y) * targetWidth + x;
+					(Pixel::Load(target[index]) + blurred).Store(target[index]);
+				}
+			}
+		});
+	}
+
+	void PostProcessChain::Composite(const Math::Float4* color, const float* depth, const float* motion, Math::Float4* output)
+	{
+		const int width = m_width;
+		const int height = m_height;
+		const int levelCount = static_cast<int>(m_levels.size());
+
+		const bool bloom = m_settings.bloom;
+		const Math::Float4* bloomImage = bloom ? m_bloom[0].data() : nullptr;
+		const Pixel bloomIntensity = Pixel::Splat(m_settings.bloomIntensity);
+
+		const bool depthOfField = m_settings.depthOfField;
+		const float cocScale = m_settings.maxBlurRadius / m_settings.focusRange;
+		const int spreadLevel = levelCount - 1; // Coarsest level carries the near field circle of confusion furthest
+
+		const bool motionBlur = m_settings.motionBlur;
+		const int sampleCount = std::max<int>(m_settings.motionBlurSamples, 1);
+		const Pixel sampleWeight = Pixel::Splat(1.0f / sampleCount);
+
+		const auto sampleLevel = [&](const Math::Float4* image, int level, float u, float v)
+		{
+			const Rectangle& size = m_levelSizes[level];
+			return SIMD::SampleBilinear(image, size.width, size.height, u * size.width - 0.5f, v * size.height - 0.5f);
+		};
+
+		ForEachTile(width, height, [&](int x0, int y0, int x1, int y1)
+		{
+			for (int y = y0; y < y1; y++)
+			{
+				const float v = (static_cast<float>(y) + 0.5f) / height;
+				for (int x = x0; x < x1; x++)
+				{
+					const float u = (static_cast<float>(x) + 0.5f) / width;
+					const size_t index = size_t(y) * width + x;
+
+					Pixel result = Pixel::Load(color[index]);
+
+					if (motionBlur)
+					{
+						// Gather along the motion vector centered on the pixel, as the exposure straddles the frame time
+						const float velocityX = motion[index * 2] * width * m_settings.motionBlurScale;
+						const float velocityY = motion[index * 2 + 1] * height * m_settings.motionBlurScale;
+						if (velocityX * velocityX + velocityY * velocityY > 0.25f)
+						{
+							Pixel sum = Pixel::Splat(0.0f);
+							for (int s = 0; s < sampleCount; s++)
+							{
+								const float t = (static_cast<float>(s) + 0.5f) / sampleCount - 0.5f;
+								const int sx = std::clamp(static_cast<int>(std::lround(static_cast<float>(x) + velocityX * t)), 0, width - 1);
+								const int sy = std::clamp(static_cast<int>(std::lround(static_cast<float>(y) + velocityY * t)), 0, height - 1);
+								sum = sum + Pixel::Load(color[size_t(sy) * width + sx]);
+							}
+							result = sum * sampleWeight;
+						}
+					}
+
+					if (depthOfField)
+					{
+						Math::Float4 spread;
+						sampleLevel(m_levels[spreadLevel].data(), spreadLevel, u, v).Store(spread);
+						const float coc = std::max(std::min(std::abs(depth[index] - m_settings.focusDistance) * cocScale, m_settings.maxBlurRadius), spread.w);
+
+						// Blend towards the chain level whose footprint matches the circle of confusion
+						if (coc > 1.0f)
+						{
+							const float level = std::clamp(std::log2(coc) - 1.0f, 0.0f, static_cast<float>(levelCount - 1));
+							const int fine = static_cast<int>(level);
+							const int coarse = std::min(fine + 1, levelCount - 1);
+							const Pixel blurred = Lerp(sampleLevel(m_levels[fine].data(), fine, u, v), sampleLevel(m_levels[coarse].data(), coarse, u, v), level - fine);
+							result = Lerp(result, blurred, std::min(coc - 1.0f, 1.0f));
+						}
+					}
+
+					if (bloom)
+					{
+						result = result + sampleLevel(bloomImage, 0, u, v) * bloomIntensity;
+					}
+
+					result.Store(output[index]);
+					output[index].w = color[index].w;
+				}
+			}
+		});
+	}
+
+	void PostProcessChain::Execute(const Math::Float4* color, const float* depth, const float* motion, Math::Float4* output)
+	{
+		if (m_passes.empty())
+		{
+			std::memcpy(output, color, size_t(m_width) * m_height * sizeof(Math::Float4));
+			return;
+		}
+
+		for (const PostProcessPass& pass : m_passes)
+		{
+			switch (pass.type)
+			{
+			case PostProcessPassType::Downsample:
+				Downsample(pass.targetLevel, color, depth);
+				break;
+			case PostProcessPassType::Upsample:
+				Upsample(pass.targetLevel);
+				break;
+			case PostProcessPassType::Composite:
+				Composite(color, depth, motion, output);
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <PostProcessChain.h>
+
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	constexpr uint16_t Width = 64;
+	constexpr uint16_t Height = 64;
+
+	struct Frame
+	{
+		std::vector<Math::Float4> color;
+		std::vector<float> depth;
+		std::vector<float> motion;
+		std::vector<Math::Float4> output;
+
+		Frame(uint16_t width, uint16_t height, const Math::Float4& fill)
+			: color(size_t(width) * height, fill), depth(size_t(width) * height, 10.0f), motion(size_t(width) * height * 2, 0.0f), output(size_t(width) * height)
+		{}
+	};
+
+	// Checkerboard of dim values, so blurring would change it
+	Frame MakeCheckerFrame(uint16_t width, uint16_t height)
+	{
+		Frame frame(width, height, Math::Float4{ 0.0f, 0.0f, 0.0f, 1.0f });
+		for (size_t y = 0; y < height; y++)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				const float value = ((x + y) % 2) ? 0.6f : 0.1f;
+				frame.color[y * width + x] = Math::Float4{ value, value * 0.5f, value * 0.25f, 1.0f };
+			}
+		}
+
+		return frame;
+	}
+
+	float SumRed(const std::vector<Math::Float4>& image)
+	{
+		float sum = 0.0f;
+		for (const Math::Float4& pixel : image)
+			sum += pixel.x;
+
+		return sum;
+	}
+
+	void ExpectIdentity(const Frame& frame)
+	{
+		for (size_t i = 0; i < frame.color.size(); i++)
+		{
+			ASSERT_FLOAT_EQ(frame.output[i].x, frame.color[i].x) << "pixel " << i;
+			ASSERT_FLOAT_EQ(frame.output[i].y, frame.color[i].y) << "pixel " << i;
+			ASSERT_FLOAT_EQ(frame.output[i].z, frame.color[i].z) << "pixel " << i;
+			ASSERT_FLOAT_EQ(frame.output[i].w, frame.color[i].w) << "pixel " << i;
+		}
+	}
+}
+
+TEST(PostProcessChain, NoEffectsPlansNoPasses)
+{
+	PostProcessChain chain;
+	chain.Configure(PostProcessSettings{}, Width, Height);
+	EXPECT_TRUE(chain.GetPasses().empty());
+
+	Frame frame = MakeCheckerFrame(Width, Height);
+	chain.Execute(frame.color.data(), frame.depth.data(), frame.motion.data(), frame.output.data());
+	ExpectIdentity(frame);
+}
+
+TEST(PostProcessChain, MotionBlurOnlyPlansComposite)
+{
+	PostProcessSettings settings;
+	settings.motionBlur = true;
+
+	PostProcessChain chain;
+	chain.Configure(settings, Width, Height);
+
+	ASSERT_EQ(chain.GetPasses().size(), 1u);
+	EXPECT_EQ(chain.GetPasses()[0].type, PostProcessPassType::Composite);
+	EXPECT_EQ(chain.GetLevelCount(), 0u);
+}
+
+TEST(PostProcessChain, BloomAndDepthOfFieldShareTheChain)
+{
+	PostProcessSettings settings;
+	settings.bloom = true;
+	settings.bloomLevels = 3;
+	settings.depthOfField = true;
+	settings.maxBlurRadius = 8.0f; // Needs 3 levels as well
+	settings.motionBlur = true;
+
+	PostProcessChain chain;
+	chain.Configure(settings, Width, 32);
+
+	const std::vector<PostProcessPass>& passes = chain.GetPasses();
+	ASSERT_EQ(passes.size(), 6u);
+	ASSERT_EQ(chain.GetLevelCount(), 3u);
+
+	const PostProcessPassType expectedTypes[6] = { PostProcessPassType::Downsample, PostProcessPassType::Downsample, PostProcessPassType::Downsample,
+		PostProcessPassType::Upsample, PostProcessPassType::Upsample, PostProcessPassType::Composite };
+	const uint8_t expectedSources[6] = { PostProcessPass::SceneColor, 0, 1, 2, 1, PostProcessPass::SceneColor };
+	const uint8_t expectedTargets[6] = { 0, 1, 2, 1, 0, PostProcessPass::SceneColor };
+	const uint16_t expectedWidths[6] = { 32, 16, 8, 16, 32, Width };
+	const uint16_t expectedHeights[6] = { 16, 8, 4, 8, 16, 32 };
+	for (size_t i = 0; i < passes.size(); i++)
+	{
+		EXPECT_EQ(passes[i].type, expectedTypes[i]) << "pass " << i;
+		EXPECT_EQ(passes[i].sourceLevel, expectedSources[i]) << "pass " << i;
+		EXPECT_EQ(passes[i].targetLevel, expectedTargets[i]) << "pass " << i;
+		EXPECT_EQ(passes[i].width, expectedWidths[i]) << "pass " << i;
+		EXPECT_EQ(passes[i].height, expectedHeights[i]) << "pass " << i;
+	}
+}
+
+TEST(PostProcessChain, DimImageDoesNotBloom)
+{
+	PostProcessSettings settings;
+	settings.bloom = true;
+	settings.bloomThreshold = 1.0f;
+	settings.bloomKnee = 0.25f;
+
+	PostProcessChain chain;
+	chain.Configure(settings, Width, Height);
+
+	Frame frame = MakeCheckerFrame(Width, Height);
+	chain.Execute(frame.color.data(), frame.depth.data(), frame.motion.data(), frame.output.data());
+	ExpectIdentity(frame);
+}
+
+TEST(PostProcessChain, BloomSpreadsBoundedEnergy)
+{
+	PostProcessSettings settings;
+	settings.bloom = true;
+	settings.bloomIntensity = 0.5f;
+	settings.bloomThreshold = 1.0f;
+	settings.bloomKnee = 0.5f;
+	settings.bloomLevels = 4;
+
+	PostProcessChain chain;
+	chain.Configure(settings, Width, Height);
+
+	// 2x2 block aligned with the chain, 8 of its 9 units of brightness are above the threshold
+	Frame frame(Width, Height, Math::Float4{ 0.0f, 0.0f, 0.0f, 1.0f });
+	for (const size_t index : { 32 * Width + 32, 32 * Width + 33, 33 * Width + 32, 33 * Width + 33 })
+		frame.color[index] = Math::Float4{ 9.0f, 9.0f, 9.0f, 1.0f };
+
+	chain.Execute(frame.color.data(), frame.depth.data(), frame.motion.data(), frame.output.data());
+
+	// Every level passes on the thresholded energy, and the upsampling filters preserve it away from the borders
+	const float thresholdedEnergy = 4.0f * 8.0f;
+	const float added = SumRed(frame.output) - SumRed(frame.color);
+	ASSERT_GT(added, 0.0f);
+	EXPECT_NEAR(added, settings.bloomIntensity * settings.bloomLevels * thresholdedEnergy, 0.02f * added);
+
+	// The glow reaches beyond the block
+	EXPECT_GT(frame.output[32 * Width + 40].x, 0.0f);
+	EXPECT_LT(frame.output[32 * Width + 40].x, frame.output[32 * Width + 34].x);
+}
+
+TEST(PostProcessChain, DepthOfFieldKeepsFocusPlaneSharp)
+{
+	PostProcessSettings settings;
+	settings.depthOfField = true;
+	settings.focusDistance = 10.0f;
+	settings.focusRange = 2.0f;
+	settings.maxBlurRadius = 8.0f;
+
+	PostProcessChain chain;
+	chain.Configure(settings, Width, Height);
+
+	Frame frame = MakeCheckerFrame(Width, Height);
+	chain.Execute(frame.color.data(), frame.depth.data(), frame.motion.data(), frame.output.data());
+	ExpectIdentity(frame);
+
+	// Out of focus the checkerboard is averaged away
+	std::fill(frame.depth.begin(), frame.depth.end(), 30.0f);
+	chain.Execute(frame.color.data(), frame.depth.data(), frame.motion.data(), frame.output.data());
+	EXPECT_NEAR(frame.output[32 * Width + 32].x, 0.35f, 0.05f);
+}
+
+TEST(PostProcessChain, MotionBlurWithoutMotionIsIdentity)
+{
+	PostProcessSettings settings;
+	settings.motionBlur = true;
+	settings.motionBlurScale = 1.0f;
+
+	PostProcessChain chain;
+	chain.Configure(settings, Width, Height);
+
+	Frame frame = MakeCheckerFrame(Width, Height);
+	chain.Execute(frame.color.data(), frame.depth.data(), frame.motion.data(), frame.output.data());
+	ExpectIdentity(frame);
+}
+
+TEST(PostProcessChain, SinglePixelFrameRunsEveryEffect)
+{
+	PostProcessSettings settings;
+	settings.bloom = true;
+	settings.depthOfField = true;
+	settings.maxBlurRadius = 0.5f;
+	settings.motionBlur = true;
+
+	PostProcessChain chain;
+	chain.Configure(settings, 1, 1);
+	ASSERT_EQ(chain.GetLevelCount(), 1u);
+	EXPECT_EQ(chain.GetLevelSize(0).width, 1);
+	EXPECT_EQ(chain.GetLevelSize(0).height, 1);
+
+	Frame frame(1, 1, Math::Float4{ 4.0f, 2.0f, 0.5f, 1.0f });
+	chain.Execute(frame.color.data(), frame.depth.data(), frame.motion.data(), frame.output.data());
+	EXPECT_GT(frame.output[0].x, frame.color[0].x);
+}
+
+TEST(PostProcessChain, RejectsInvalidSettings)
+{
+	PostProcessChain chain;
+	EXPECT_THROW(chain.Configure(PostProcessSettings{}, 0, 16), std::invalid_argument);
+
+	PostProcessSettings settings;
+	settings.depthOfField = true;
+	settings.focusRange = 0.0f;
+	EXPECT_THROW(chain.Configure(settings, 16, 16), std::invalid_argument);
+}
@@ -0,0 +1,156 @@
+#ifndef ULTREALITY_RENDERING_CASCADED_SHADOWS_H
+#define ULTREALITY_RENDERING_CASCADED_SHADOWS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include <vector>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	struct CascadedShadowSettings
+	{
+		static constexpr size_t MaxCascades = 4;
+
+		uint8_t cascadeCount = 4;
+		uint16_t resolution = 2048;			// Width and height of each cascade's shadow map
+		float maxDistance = 200.0f;			// View distance covered by the last cascade
+		float splitLambda = 0.75f;			// Blend between uniform (0) and logarithmic (1) split distances
+		float casterPullback = 100.0f;		// Distance towards the light that casters outside the cascade bounds are still captured from
+		uint16_t staticGuardTexels = 128;	// Border around each cascade's cached static depth map. The camera may drift this many texels in any direction before the cache is rebuilt
+		std::array<uint8_t, MaxCascades> updateInterval = { 1, 1, 2, 4 }; // Frames between re-renders of each cascade
+	};
+
+	struct ShadowCameraDesc
+	{
+		Math::Float3 position;	// World space camera position
+		Math::Float3 forward;	// World space unit view direction
+		float verticalFov;		// Radians
+		float aspectRatio;		// Width divided by height
+		float nearZ;
+	};
+
+	/// <summary>
+	/// What the renderer has to do for a cascade this frame. When rebuildStaticCache is set, render staticCasters into the cascade's
+	/// cached static depth map with staticViewProj first. The cached map is resolution + 2 * staticGuardTexels wide and high. When render is set,
+	/// copy the resolution sized region at (staticOffsetX, staticOffsetY) of the static depth map into the cascade's shadow map and render dynamicCasters on top
+	/// </summary>
+	struct CascadePlan
+	{
+		Math::Float4x4 viewProj;		// Light view-projection the shadow map contents are rendered with. Unchanged on frames the cascade is not rendered
+		Math::Float4x4 staticViewProj;	// Light view-projection of the cached static depth map. Shares viewProj's texel grid and depth range
+		uint16_t staticOffsetX;			// Texel of the static depth map that maps to the shadow map's top left texel
+		uint16_t staticOffsetY;
+		float splitNear;				// View depth range the cascade covers
+		float splitFar;
+		bool render;
+		bool rebuildStaticCache;
+		std::vector<uint32_t> staticCasters;	// Only filled when rebuildStaticCache is set
+		std::vector<uint32_t> dynamicCasters;	// Only filled when render is set
+	};
+
+	/// <summary>
+	/// Schedules a directional light's cascaded shadow maps. Cascade bounds are stable under camera rotation and snapped to shadow map texels,
+	/// static caster depth is cached per cascade with a guard band and a padded depth range, so it is only rebuilt when the cascade leaves the guard band,
+	/// its radius changes or a static caster changes. Distant cascades re-render at staggered intervals
+	/// </summary>
+	class CascadedShadowScheduler
+	{
+	protected:
+		struct CascadeState
+		{
+			Math::Float3 origin;		// Snapped light space center of the cascade's current shadow map
+			Math::Float3 staticOrigin;	// Snapped light space center of the cached static depth map, z is the center of the shared depth range
+			float radius;
+			bool valid;					// The shadow map has been rendered at least once
+			bool staticValid;			// The cached static depth covers origin and matches the static casters
+		};
+
+		CascadedShadowSettings m_settings;
+		std::array<CascadeState, CascadedShadowSettings::MaxCascades> m_state{};
+		std::array<CascadePlan, CascadedShadowSettings::MaxCascades> m_plans{};
+		Math::Float3 m_lightDirection{ 0.0f, -1.0f, 0.0f };
+
+		// Caster bounding spheres as SoA, indexed by caster id
+		std::vector<float> m_casterX;
+		std::vector<float> m_casterY;
+		std::vector<float> m_casterZ;
+		std::vector<float> m_casterRadius;	// Negative for removed casters
+		std::vector<uint8_t> m_casterStatic;
+
+		// Per update scratch, casters in light space
+		std::vector<float> m_lightX;
+		std::vector<float> m_lightY;
+		std::vector<float> m_lightZ;
+		std::vector<uint8_t> m_overlap;
+
+		void InvalidateStaticCaches() noexcept;
+
+		/// <summary>
+		/// Flag the casters whose light space bounds overlap a light space box in m_overlap
+		/// </summary>
+		void CullCasters(float originX, float originY, float halfSize, float zNear, float zFar);
+
+	public:
+		/// <summary>
+		/// Configure the cascades. Invalidates every cached shadow map
+		/// </summary>
+		/// <exception cref="std.invalid_argument">Thrown if the cascade count is 0 or above MaxCascades</exception>
+		void Configure(const CascadedShadowSettings& settings);
+
+		/// <summary>
+		/// Get the cascade configuration
+		/// </summary>
+		const CascadedShadowSettings& GetSettings() const noexcept
+		{
+			return m_settings;
+		}
+
+		/// <summary>
+		/// Register a shadow caster
+		/// </summary>
+		/// <param name="center">World space bounding sphere center</param>
+		/// <param name="radius">Bounding sphere radius</param>
+		/// <param name="isStatic">Static casters are rendered into the cached depth maps and must not move every frame</param>
+		/// <returns>Id of the caster, referenced by the caster lists of <see cref="CascadePlan"/></returns>
+		uint32_t AddCaster(const Math::Float3& center, float radius, bool isStatic);
+
+		/// <summary>
+		/// Move a caster. Moving a static caster invalidates the cached static depth maps
+		/// </summary>
+		void UpdateCaster(uint32_t caster, const Math::Float3& center, float radius) noexcept;
+
+		/// <summary>
+		/// Remove a caster. Its id is not reused
+		/// </summary>
+		void RemoveCaster(uint32_t caster) noexcept;
+
+		/// <summary>
+		/// Compute the cascades and cull the casters of the cascades that re-render this frame
+		/// </summary>
+		/// <param name="camera">The main camera</param>
+		/// <param name="lightDirection">World space unit direction the light travels in</param>
+		/// <param name="frameIndex">Monotonic frame counter, used to stagger cascade updates</param>
+		void Update(const ShadowCameraDesc& camera, const Math::Float3& lightDirection, uint64_t frameIndex);
+
+		/// <summary>
+		/// Get the plan of a cascade from the last <see cref="Update"/>
+		/// </summary>
+		const CascadePlan& GetCascade(size_t cascade) const noexcept
+		{
+			return m_plans[cascade];
+		}
+
+		/// <summary>
+		/// Get the number of cascades
+		/// </summary>
+		size_t GetCascadeCount() const noexcept
+		{
+			return m_settings.cascadeCount;
+		}
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_CASCADED_SHADOWS_H
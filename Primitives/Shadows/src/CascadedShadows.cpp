@@ -0,0 +1,307 @@
+#include <CascadedShadows.h>
+#include <ParallelFor.h>
+#include <RenderingSIMD.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace UltReality::Rendering
+{
+	namespace
+	{
+		constexpr size_t CasterGrainSize = 2048;
+
+		// Cascade radii are rounded up to this step so floating point noise never changes the texel size
+		constexpr float RadiusQuantum = 1.0f / 16.0f;
+
+		// Light directions closer than this are treated as unchanged
+		constexpr float LightDirectionTolerance = 0.99999f;
+
+		inline float Dot(const Math::Float3& a, const Math::Float3& b) noexcept
+		{
+			return a.x * b.x + a.y * b.y + a.z * b.z;
+		}
+
+		inline Math::Float3 Cross(const Math::Float3& a, const Math::Float3& b) noexcept
+		{
+			return Math::Float3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+		}
+
+		inline Math::Float3 Normalize(const Math::Float3& v) noexcept
+		{
+			const float length = std::sqrt(Dot(v, v));
+			return length > 0.0f ? Math::Float3{ v.x / length, v.y / length, v.z / length } : Math::Float3{ 0.0f, 0.0f, 1.0f };
+		}
+
+		struct LightBasis
+		{
+			Math::Float3 right, up, forward;
+		};
+
+		inline LightBasis MakeBasis(const Math::Float3& direction) noexcept
+		{
+			LightBasis basis;
+			basis.forward = Normalize(direction);
+			const Math::Float3 reference = std::abs(basis.forward.y) < 0.99f ? Math::Float3{ 0.0f, 1.0f, 0.0f } : Math::Float3{ 1.0f, 0.0f, 0.0f };
+			basis.right = Normalize(Cross(reference, basis.forward));
+			basis.up = Cross(basis.forward, basis.right);
+
+			return basis;
+		}
+
+		inline float Snap(float value, float step) noexcept
+		{
+			return std::floor(value / step) * step;
+		}
+
+		// Orthographic projection of a light space box, composed with the light view rotation. Row-vector convention, depth in [0, 1]
+		inline void LightViewProjection(Math::Float4x4& viewProj, const LightBasis& basis, float originX, float originY, float halfSize, float zNear, float zFar) noexcept
+		{
+			const float invSize = 1.0f / halfSize;
+			const float invDepth = 1.0f / (zFar - zNear);
+			auto& m = viewProj.m;
+			m[0][0] = basis.right.x * invSize;	m[0][1] = basis.up.x * invSize;	m[0][2] = basis.forward.x * invDepth;	m[0][3] = 0.0f;
+			m[1][0] = basis.right.y * invSize;	m[1][1] = basis.up.y * invSize;	m[1][2] = basis.forward.y * invDepth;	m[1][3] = 0.0f;
+			m[2][0] = basis.right.z * invSize;	m[2][1] = basis.up.z * invSize;	m[2][2] = basis.forward.z * invDepth;	m[2][3] = 0.0f;
+			m[3][0] = -originX * invSize;		m[3][1] = -originY * invSize;	m[3][2] = -zNear * invDepth;			m[3][3] = 1.0f;
+		}
+	}
+
+	void CascadedShadowScheduler::InvalidateStaticCaches() noexcept
+	{
+		for (CascadeState& state : m_state)
+			state.staticValid = false;
+	}
+
+	void CascadedShadowScheduler::Configure(const CascadedShadowSettings& settings)
+	{
+		if (settings.cascadeCount == 0 || settings.cascadeCount > CascadedShadowSettings::MaxCascades)
+			throw std::invalid_argument("Cascade count must be in the range [1, MaxCascades]");
+		if (settings.resolution == 0)
+			throw std::invalid_argument("Cascade resolution must be greater than 0");
+
+		m_settings = settings;
+		m_state.fill(CascadeState{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, 0.0f, false, false });
+	}
+
+	uint32_t CascadedShadowScheduler::AddCaster(const Math::Float3& center, float radius, bool isStatic)
+	{
+		m_casterX.push_back(center.x);
+		m_casterY.push_back(center.y);
+		m_casterZ.push_back(center.z);
+		m_casterRadius.push_back(std::max(radius, 0.0f));
+		m_casterStatic.push_back(isStatic ? 1 : 0);
+
+		if (isStatic)
+			InvalidateStaticCaches();
+
+		return static_cast<uint32_t>(m_casterRadius.size() - 1);
+	}
+
+	void CascadedShadowScheduler::UpdateCaster(uint32_t caster, const Math::Float3& center, float radius) noexcept
+	{
+		m_casterX[caster] = center.x;
+		m_casterY[caster] = center.y;
+		m_casterZ[caster] = center.z;
+		m_casterRadius[caster] = std::max(radius, 0.0f);
+
+		if (m_casterStatic[caster])
+			InvalidateStaticCaches();
+	}
+
+	void CascadedShadowScheduler::RemoveCaster(uint32_t caster) noexcept
+	{
+		m_casterRadius[caster] = -1.0f;
+
+		if (m_casterStatic[caster])
+			InvalidateStaticCaches();
+	}
+
+	void CascadedShadowScheduler::Update(const ShadowCameraDesc& camera, const Math::Float3& lightDirection, uint64_t frameIndex)
+	{
+		const Math::Float3 direction = Normalize(lightDirection);
+		if (Dot(direction, m_lightDirection) < LightDirectionTolerance)
+		{
+			// Every cached map was rendered from the old direction
+			m_lightDirection = direction;
+			for (CascadeState& state : m_state)
+				state.valid = state.staticValid = false;
+		}
+
+		const LightBasis basis = MakeBasis(m_lightDirection);
+		const float tanY = std::tan(camera.verticalFov * 0.5f);
+		const float tanX = tanY * camera.aspectRatio;
+		const float k2 = tanX * tanX + tanY * tanY;
+		const float nearZ = camera.nearZ;
+		const float farZ = std::max(m_settings.maxDistance, nearZ * 1.001f);
+		const size_t cascadeCount = m_settings.cascadeCount;
+
+		bool anyRender = false;
+		for (size_t i = 0; i < cascadeCount; i++)
+		{
+			CascadeState& state = m_state[i];
+			CascadePlan& plan = m_plans[i];
+
+			const uint8_t interval = std::max<uint8_t>(m_settings.updateInterval[i], 1);
+			const bool due = !state.valid || !state.staticValid || (frameIndex + i) % interval == 0;
+			plan.render = due;
+			plan.rebuildStaticCache = false;
+			plan.staticCasters.clear();
+			plan.dynamicCasters.clear();
+			if (!due)
+				continue; // Keep the matrix and splits the map was rendered with
+
+			// Practical split scheme between logarithmic and uniform distribution
+			const auto split = [&](size_t s)
+			{
+				const float t = static_cast<float>(s) / cascadeCount;
+				const float logarithmic = nearZ * std::pow(farZ / nearZ, t);
+				const float uniform = nearZ + (farZ - nearZ) * t;
+				return m_settings.splitLambda * logarithmic + (1.0f - m_settings.splitLambda) * uniform;
+			};
+			const float splitNear = split(i);
+			const float splitFar = split(i + 1);
+
+			// Smallest sphere around the frustum slice. It only depends on the projection so it is stable under camera rotation
+			const float depth = std::clamp(0.5f * (splitNear + splitFar) * (1.0f + k2), splitNear, splitFar);
+			const float nearDistance = std::sqrt((depth - splitNear) * (depth - splitNear) + splitNear * splitNear * k2);
+			const float farDistance = std::sqrt((splitFar - depth) * (splitFar - depth) + splitFar * splitFar * k2);
+			const float radius = std::ceil(std::max(nearDistance, farDistance) / RadiusQuantum) * RadiusQuantum;
+
+			const Math::Float3 center{ camera.position.x + camera.forward.x * depth, camera.position.y + camera.forward.y * depth, camera.position.z + camera.forward.z * depth };
+
+			// Snap the light space center to whole texels so static geometry rasterizes identically frame to frame
+			const float texel = 2.0f * radius / m_settings.resolution;
+			const Math::Float3 origin{ Snap(Dot(basis.right, center), texel), Snap(Dot(basis.up, center), texel), Dot(basis.forward, center) };
+
+			// The static cache stays valid while the cascade's texel grid stays inside its guard band and its depth range inside the padding
+			const long guardTexels = m_settings.staticGuardTexels;
+			const float guard = guardTexels * texel;
+			long shiftX = std::lround((origin.x - state.staticOrigin.x) / texel);
+			long shiftY = std::lround((origin.y - state.staticOrigin.y) / texel);
+			if (!state.staticValid || radius != state.radius || std::abs(shiftX) > guardTexels || std::abs(shiftY) > guardTexels || std::abs(origin.z - state.staticOrigin.z) > guard)
+			{
+				state.staticOrigin = origin;
+				state.staticValid = false;
+				shiftX = shiftY = 0;
+			}
+
+			plan.rebuildStaticCache = !state.staticValid;
+			state.origin = origin;
+			state.radius = radius;
+			state.valid = true;
+			state.staticValid = true;
+			plan.splitNear = splitNear;
+			plan.splitFar = splitFar;
+
+			// Texture rows run against light space up
+			plan.staticOffsetX = static_cast<uint16_t>(guardTexels + shiftX);
+			plan.staticOffsetY = static_cast<uint16_t>(guardTexels - shiftY);
+
+			// Both maps share the padded depth range of the cache so the static depth can be copied as is
+			const float zNear = state.staticOrigin.z - radius - guard - m_settings.casterPullback;
+			const float zFar = state.staticOrigin.z + radius + guard;
+			LightViewProjection(plan.viewProj, basis, origin.x, origin.y, radius, zNear, zFar);
+			LightViewProjection(plan.staticViewProj, basis, state.staticOrigin.x, state.staticOrigin.y, radius + guard, zNear, zFar);
+
+			anyRender = true;
+		}
+
+		if (!anyRender)
+			return;
+
+		// Casters to light space once, shared by every cascade
+		const size_t casterCount = m_casterRadius.size();
+		m_lightX.resize(casterCount);
+		m_lightY.resize(casterCount);
+		m_lightZ.resize(casterCount);
+		m_overlap.resize(casterCount);
+
+		Parallel::ParallelFor(casterCount, CasterGrainSize, [&](size_t begin, size_t end)
+		{
+			for (size_t c = begin; c < end; c++)
+			{
+				const Math::Float3 p{ m_casterX[c], m_casterY[c], m_casterZ[c] };
+				m_lightX[c] = Dot(basis.right, p);
+				m_lightY[c] = Dot(basis.up, p);
+				m_lightZ[c] = Dot(basis.forward, p);
+			}
+		});
+
+		for (size_t i = 0; i < cascadeCount; i++)
+		{
+			CascadePlan& plan = m_plans[i];
+			if (!plan.render)
+				continue;
+
+			const CascadeState& state = m_state[i];
+			const float guard = m_settings.staticGuardTexels * 2.0f * state.radius / m_settings.resolution;
+			const float zNear = state.staticOrigin.z - state.radius - guard - m_settings.casterPullback;
+			const float zFar = state.staticOrigin.z + state.radius + guard;
+
+			CullCasters(state.origin.x, state.origin.y, state.radius, zNear, zFar);
+			for (size_t c = 0; c < casterCount; c++)
+			{
+				if (m_overlap[c] && !m_casterStatic[c])
+					plan.dynamicCasters.push_back(static_cast<uint32_t>(c));
+			}
+
+			if (!plan.rebuildStaticCache)
+				continue;
+
+			// The static cache covers the guard band as well
+			CullCasters(state.staticOrigin.x, state.staticOrigin.y, state.radius + guard, zNear, zFar);
+			for (size_t c = 0; c < casterCount; c++)
+			{
+				if (m_overlap[c] && m_casterStatic[c])
+					plan.staticCasters.push_back(static_cast<uint32_t>(c));
+			}
+		}
+	}
+
+	void CascadedShadowScheduler::CullCasters(float originX, float originY, float halfSize, float zNear, float zFar)
+	{
+		Parallel::ParallelFor(m_casterRadius.size(), CasterGrainSize, [&](size_t begin, size_t end)
+		{
+			size_t c = begin;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+			const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 originXV = _mm_set1_ps(originX);
+			const __m128 originYV = _mm_set1_ps(originY);
+			const __m128 halfSizeV = _mm_set1_ps(halfSize);
+			const __m128 zNearV = _mm_set1_ps(zNear);
+			const __m128 zFarV = _mm_set1_ps(zFar);
+
+			for (; c + 4 <= end; c += 4)
+			{
+				const __m128 r = _mm_loadu_ps(m_casterRadius.data() + c);
+				const __m128 z = _mm_loadu_ps(m_lightZ.data() + c);
+				const __m128 reach = _mm_add_ps(halfSizeV, r);
+
+				__m128 inside = _mm_cmpge_ps(r, zero);
+				inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_and_ps(_mm_sub_ps(_mm_loadu_ps(m_lightX.data() + c), originXV), absMask), reach));
+				inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_and_ps(_mm_sub_ps(_mm_loadu_ps(m_lightY.data() + c), originYV), absMask), reach));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(z, r), zNearV));
+				inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(z, r), zFarV));
+
+				const int mask = _mm_movemask_ps(inside);
+				for (size_t lane = 0; lane < 4; lane++)
+					m_overlap[c + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+			}
+#endif
+
+			for (; c < end; c++)
+			{
+				const float r = m_casterRadius[c];
+				m_overlap[c] = r >= 0.0f
+					&& std::abs(m_lightX[c] - originX) <= halfSize + r
+					&& std::abs(m_lightY[c] - originY) <= halfSize + r
+					&& m_lightZ[c] + r >= zNear
+					&& m_lightZ[c] - r <= zFar ? 1 : 0;
+			}
+		});
+	}
+}
@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include <CascadedShadows.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	const Math::Float3 LightDirection{ 0.3f, -1.0f, 0.2f };
+
+	// Unit world space direction perpendicular to LightDirection, moving along it keeps the light space depth
+	const Math::Float3 Across{ 0.5547002f, 0.0f, -0.8320503f };
+
+	struct Texel
+	{
+		float u, v, depth;
+	};
+
+	// Texel coordinates of a world point in a map of the given size rendered with a row-vector light view-projection
+	Texel ToTexel(const Math::Float4x4& viewProj, const Math::Float3& p, float size)
+	{
+		const auto& m = viewProj.m;
+		const float x = p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0];
+		const float y = p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1];
+		const float z = p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2];
+
+		return Texel{ (x * 0.5f + 0.5f) * size, (0.5f - y * 0.5f) * size, z };
+	}
+
+	// World size of a texel of the shadow map, the first column of the orthographic projection is light space right / radius
+	float TexelSize(const CascadePlan& plan, uint16_t resolution)
+	{
+		const auto& m = plan.viewProj.m;
+		const float radius = 1.0f / std::sqrt(m[0][0] * m[0][0] + m[1][0] * m[1][0] + m[2][0] * m[2][0]);
+
+		return 2.0f * radius / resolution;
+	}
+
+	Math::Float3 Offset(const Math::Float3& p, const Math::Float3& direction, float distance)
+	{
+		return Math::Float3{ p.x + direction.x * distance, p.y + direction.y * distance, p.z + direction.z * distance };
+	}
+
+	bool SameMatrix(const Math::Float4x4& a, const Math::Float4x4& b)
+	{
+		for (size_t r = 0; r < 4; r++)
+		{
+			for (size_t c = 0; c < 4; c++)
+			{
+				if (a.m[r][c] != b.m[r][c])
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	class CascadedShadowsTests : public ::testing::Test
+	{
+	protected:
+		CascadedShadowSettings m_settings;
+		CascadedShadowScheduler m_scheduler;
+		ShadowCameraDesc m_camera{ { 10.0f, 2.0f, -5.0f }, { 0.0f, 0.0f, 1.0f }, 1.0f, 16.0f / 9.0f, 0.1f };
+		uint64_t m_frame = 0;
+
+		void SetUp() override
+		{
+			m_settings.updateInterval = { 1, 1, 1, 1 };
+			m_scheduler.Configure(m_settings);
+			for (int i = 0; i < 100; i++)
+				m_scheduler.AddCaster({ static_cast<float>(i % 10) * 8.0f - 40.0f, 0.0f, static_cast<float>(i / 10) * 8.0f }, 2.0f, i % 4 != 0);
+		}
+
+		void Update()
+		{
+			m_scheduler.Update(m_camera, LightDirection, m_frame++);
+		}
+	};
+}
+
+TEST_F(CascadedShadowsTests, SubTexelCameraMotionKeepsTexelGrid)
+{
+	Update();
+
+	std::vector<Texel> reference(m_scheduler.GetCascadeCount());
+	std::vector<float> texelSize(m_scheduler.GetCascadeCount());
+	std::vector<Math::Float3> points(m_scheduler.GetCascadeCount());
+	for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+	{
+		const CascadePlan& plan = m_scheduler.GetCascade(c);
+		texelSize[c] = TexelSize(plan, m_settings.resolution);
+		points[c] = Offset(m_camera.position, m_camera.forward, 0.5f * (plan.splitNear + plan.splitFar));
+		reference[c] = ToTexel(plan.viewProj, points[c], m_settings.resolution);
+	}
+
+	// Drift across and along the view by a fraction of the smallest texel per frame
+	for (int step = 0; step < 200; step++)
+	{
+		m_camera.position = Offset(Offset(m_camera.position, Across, 0.13f * texelSize[0]), m_camera.forward, 0.07f * texelSize[0]);
+		Update();
+
+		for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+		{
+			const CascadePlan& plan = m_scheduler.GetCascade(c);
+			ASSERT_EQ(TexelSize(plan, m_settings.resolution), texelSize[c]) << "cascade " << c;
+
+			// The map only ever moves by whole texels, so a static point keeps its position inside its texel
+			const Texel texel = ToTexel(plan.viewProj, points[c], m_settings.resolution);
+			const float du = texel.u - reference[c].u;
+			const float dv = texel.v - reference[c].v;
+			EXPECT_NEAR(du, std::round(du), 2e-2f) << "cascade " << c << " step " << step;
+			EXPECT_NEAR(dv, std::round(dv), 2e-2f) << "cascade " << c << " step " << step;
+		}
+	}
+}
+
+TEST_F(CascadedShadowsTests, CameraRotationKeepsCascadeSize)
+{
+	Update();
+	std::vector<float> texelSize(m_scheduler.GetCascadeCount());
+	for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+		texelSize[c] = TexelSize(m_scheduler.GetCascade(c), m_settings.resolution);
+
+	for (int step = 1; step <= 36; step++)
+	{
+		const float yaw = step * 0.1745329f;
+		m_camera.forward = Math::Float3{ std::sin(yaw), 0.0f, std::cos(yaw) };
+		Update();
+
+		for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+			EXPECT_EQ(TexelSize(m_scheduler.GetCascade(c), m_settings.resolution), texelSize[c]) << "cascade " << c << " step " << step;
+	}
+}
+
+TEST_F(CascadedShadowsTests, StaticCacheIsReusedInsideGuardBand)
+{
+	Update();
+	std::vector<Math::Float4x4> staticViewProj(m_scheduler.GetCascadeCount());
+	for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+	{
+		const CascadePlan& plan = m_scheduler.GetCascade(c);
+		EXPECT_TRUE(plan.rebuildStaticCache);
+		EXPECT_FALSE(plan.staticCasters.empty()) << "cascade " << c;
+		EXPECT_EQ(plan.staticOffsetX, m_settings.staticGuardTexels);
+		EXPECT_EQ(plan.staticOffsetY, m_settings.staticGuardTexels);
+		staticViewProj[c] = plan.staticViewProj;
+	}
+
+	// Still camera
+	Update();
+	for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+	{
+		EXPECT_FALSE(m_scheduler.GetCascade(c).rebuildStaticCache) << "cascade " << c;
+		EXPECT_TRUE(m_scheduler.GetCascade(c).staticCasters.empty()) << "cascade " << c;
+	}
+
+	// Drift half the guard band of the finest cascade, every cascade keeps its cache and copies a shifted window of it
+	const float texel = TexelSize(m_scheduler.GetCascade(0), m_settings.resolution);
+	const float guardDistance = 0.5f * m_settings.staticGuardTexels * texel;
+	for (int step = 0; step < 16; step++)
+	{
+		m_camera.position = Offset(m_camera.position, Across, guardDistance / 16.0f);
+		Update();
+
+		for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+		{
+			const CascadePlan& plan = m_scheduler.GetCascade(c);
+			EXPECT_FALSE(plan.rebuildStaticCache) << "cascade " << c << " step " << step;
+			EXPECT_TRUE(SameMatrix(plan.staticViewProj, staticViewProj[c])) << "cascade " << c << " step " << step;
+		}
+	}
+
+	const int staticSize = m_settings.resolution + 2 * m_settings.staticGuardTexels;
+	for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+	{
+		// The copied window lines up texel for texel and at the same depth with the shadow map
+		const CascadePlan& plan = m_scheduler.GetCascade(c);
+		const Math::Float3 point = Offset(m_camera.position, m_camera.forward, 0.5f * (plan.splitNear + plan.splitFar));
+		const Texel shadow = ToTexel(plan.viewProj, point, m_settings.resolution);
+		const Texel cached = ToTexel(plan.staticViewProj, point, static_cast<float>(staticSize));
+		EXPECT_NEAR(cached.u - plan.staticOffsetX, shadow.u, 1e-2f) << "cascade " << c;
+		EXPECT_NEAR(cached.v - plan.staticOffsetY, shadow.v, 1e-2f) << "cascade " << c;
+		EXPECT_FLOAT_EQ(cached.depth, shadow.depth) << "cascade " << c;
+	}
+	EXPECT_NE(m_scheduler.GetCascade(0).staticOffsetX + m_scheduler.GetCascade(0).staticOffsetY, 2 * m_settings.staticGuardTexels);
+
+	// Leaving the guard band rebuilds the finest cascade
+	m_camera.position = Offset(m_camera.position, Across, 1.5f * guardDistance);
+	Update();
+	EXPECT_TRUE(m_scheduler.GetCascade(0).rebuildStaticCache);
+	EXPECT_EQ(m_scheduler.GetCascade(0).staticOffsetX, m_settings.staticGuardTexels);
+	EXPECT_EQ(m_scheduler.GetCascade(0).staticOffsetY, m_settings.staticGuardTexels);
+}
+
+TEST_F(CascadedShadowsTests, OnlyStaticCasterChangesRebuildTheCache)
+{
+	Update();
+	Update();
+
+	// Dynamic casters move every frame without touching the cache
+	m_scheduler.UpdateCaster(0, { 1.0f, 0.0f, 3.0f }, 2.0f);
+	Update();
+	for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+		EXPECT_FALSE(m_scheduler.GetCascade(c).rebuildStaticCache) << "cascade " << c;
+
+	m_scheduler.UpdateCaster(1, { 1.0f, 0.0f, 3.0f }, 2.0f);
+	Update();
+	for (size_t c = 0; c < m_scheduler.GetCascadeCount(); c++)
+		EXPECT_TRUE(m_scheduler.GetCascade(c).rebuildStaticCache) << "cascade " << c;
+}
+
+TEST(CascadedShadowScheduler, RejectsInvalidCascadeCount)
+{
+	CascadedShadowScheduler scheduler;
+	CascadedShadowSettings settings;
+	settings.cascadeCount = 0;
+	EXPECT_THROW(scheduler.Configure(settings), std::invalid_argument);
+	settings.cascadeCount = CascadedShadowSettings::MaxCascades + 1;
+	EXPECT_THROW(scheduler.Configure(settings), std::invalid_argument);
+}
@@ -0,0 +1,119 @@
+#ifndef ULTREALITY_RENDERING_TEMPORAL_UPSCALER_H
+#define ULTREALITY_RENDERING_TEMPORAL_UPSCALER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include <vector>
+
+#include <VectorTypes.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Sub-pixel offset of the frame's samples, in render target pixels with +x right and +y down. Each component is in [-0.5, 0.5)
+	/// </summary>
+	struct JitterOffset
+	{
+		float x;
+		float y;
+	};
+
+	struct TemporalUpscaleSettings
+	{
+		float blendFactor = 0.1f;		// Weight of the current frame at a sample's exact position. Lower is smoother but slower to converge
+		uint32_t jitterPhaseCount = 0;	// Length of the jitter sequence. 0 picks 8 * (output pixels / render pixels) so every output pixel receives samples
+	};
+
+	/// <summary>
+	/// Temporal anti-aliasing and upscaling stage. The scene is rendered at a reduced, jittered resolution and accumulated into a history at the output resolution
+	/// with motion vector reprojection and neighbourhood clamping. Resolve is the CPU reference of the reconstruction pass
+	/// </summary>
+	class TemporalUpscaler
+	{
+	protected:
+		TemporalUpscaleSettings m_settings;
+		uint16_t m_renderWidth = 0;
+		uint16_t m_renderHeight = 0;
+		uint16_t m_outputWidth = 0;
+		uint16_t m_outputHeight = 0;
+		uint32_t m_phaseCount = 8;
+		JitterOffset m_jitter{ 0.0f, 0.0f };
+
+		// Ping-pong history at the output resolution. Only reallocated when the output resolution changes
+		std::array<std::vector<Math::Float4>, 2> m_history;
+		size_t m_readHistory = 0;
+		bool m_historyValid = false;
+
+	public:
+		/// <summary>
+		/// Get the element of the Halton low discrepancy sequence
+		/// </summary>
+		/// <param name="index">Index in the sequence, starting at 1</param>
+		/// <param name="base">Prime base of the sequence</param>
+		/// <returns>Value in [0, 1)</returns>
+		static float Halton(uint32_t index, uint32_t base) noexcept;
+
+		/// <summary>
+		/// Get the jitter of a frame from the Halton (2, 3) sequence
+		/// </summary>
+		/// <param name="frameIndex">Monotonic frame counter</param>
+		/// <param name="phaseCount">Length of the sequence before it repeats</param>
+		static JitterOffset ComputeJitter(uint64_t frameIndex, uint32_t phaseCount) noexcept;
+
+		/// <summary>
+		/// Offset a row-vector projection matrix by a jitter so the rasterized samples move by that many render target pixels
+		/// </summary>
+		/// <param name="projection">Projection matrix to modify</param>
+		/// <param name="jitter">Offset in render target pixels</param>
+		/// <param name="renderWidth">Width of the render target</param>
+		/// <param name="renderHeight">Height of the render target</param>
+		static void ApplyJitter(Math::Float4x4& projection, const JitterOffset& jitter, uint16_t renderWidth, uint16_t renderHeight) noexcept;
+
+		/// <summary>
+		/// Configure the stage. The render resolution may change every frame (dynamic resolution) without losing the history,
+		/// changing the output resolution reallocates and resets the history
+		/// </summary>
+		/// <exception cref="std.invalid_argument">Thrown if any dimension is 0 or the render resolution exceeds the output resolution</exception>
+		void Configure(const TemporalUpscaleSettings& settings, uint16_t renderWidth, uint16_t renderHeight, uint16_t outputWidth, uint16_t outputHeight);
+
+		/// <summary>
+		/// Start a frame and compute its jitter. Apply <see cref="GetJitter"/> to the projection matrix with <see cref="ApplyJitter"/> before rendering
+		/// </summary>
+		void BeginFrame(uint64_t frameIndex) noexcept;
+
+		/// <summary>
+		/// Get the jitter of the current frame
+		/// </summary>
+		const JitterOffset& GetJitter() const noexcept
+		{
+			return m_jitter;
+		}
+
+		/// <summary>
+		/// Discard the history, for camera cuts and teleports
+		/// </summary>
+		void ResetHistory() noexcept
+		{
+			m_historyValid = false;
+		}
+
+		/// <summary>
+		/// Reconstruct the output frame on the CPU. Rows are processed in parallel, one pixel per SIMD register
+		/// </summary>
+		/// <param name="color">Jittered frame at the render resolution, row major</param>
+		/// <param name="motion">Per render pixel UV offset (2 floats) from the current to the previous frame's position, row major</param>
+		/// <param name="output">Destination at the output resolution, row major. May not alias the inputs</param>
+		void Resolve(const Math::Float4* color, const float* motion, Math::Float4* output);
+
+		/// <summary>
+		/// Get the accumulated history written by the last <see cref="Resolve"/>
+		/// </summary>
+		const std::vector<Math::Float4>& GetHistory() const noexcept
+		{
+			return m_history[m_readHistory];
+		}
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_TEMPORAL_UPSCALER_H
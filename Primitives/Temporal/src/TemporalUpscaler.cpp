@@ -0,0 +1,154 @@
+#include <TemporalUpscaler.h>
+#include <ParallelFor.h>
+#include <PixelSIMD.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace UltReality::Rendering
+{
+	using SIMD::Pixel;
+
+	namespace
+	{
+		constexpr size_t ResolveGrainSize = 8; // Output rows per task
+
+		// Gaussian fit of the Blackman-Harris window, weights the current sample by its distance to the output pixel
+		constexpr float SampleFalloff = 2.29f;
+	}
+
+	float TemporalUpscaler::Halton(uint32_t index, uint32_t base) noexcept
+	{
+		float result = 0.0f;
+		float fraction = 1.0f;
+		while (index > 0)
+		{
+			fraction /= static_cast<float>(base);
+			result += fraction * static_cast<float>(index % base);
+			index /= base;
+		}
+
+		return result;
+	}
+
+	JitterOffset TemporalUpscaler::ComputeJitter(uint64_t frameIndex, uint32_t phaseCount) noexcept
+	{
+		const uint32_t index = static_cast<uint32_t>(frameIndex % std::max<uint32_t>(phaseCount, 1)) + 1;
+
+		return JitterOffset{ Halton(index, 2) - 0.5f, Halton(index, 3) - 0.5f };
+	}
+
+	void TemporalUpscaler::ApplyJitter(Math::Float4x4& projection, const JitterOffset& jitter, uint16_t renderWidth, uint16_t renderHeight) noexcept
+	{
+		// Clip space offset scaled by w, so it works for perspective and orthographic projections. NDC y points up
+		const float offsetX = 2.0f * jitter.x / renderWidth;
+		const float offsetY = -2.0f * jitter.y / renderHeight;
+		for (size_t row = 0; row < 4; row++)
+		{
+			projection.m[row][0] += offsetX * projection.m[row][3];
+			projection.m[row][1] += offsetY * projection.m[row][3];
+		}
+	}
+
+	void TemporalUpscaler::Configure(const TemporalUpscaleSettings& settings, uint16_t renderWidth, uint16_t renderHeight, uint16_t outputWidth, uint16_t outputHeight)
+	{
+		if (renderWidth == 0 || renderHeight == 0 || outputWidth == 0 || outputHeight == 0)
+			throw std::invalid_argument("Temporal upscaler resolutions must be greater than 0");
+		if (renderWidth > outputWidth || renderHeight > outputHeight)
+			throw std::invalid_argument("Temporal upscaler render resolution must not exceed the output resolution");
+
+		m_settings = settings;
+		m_renderWidth = renderWidth;
+		m_renderHeight = renderHeight;
+
+		const float pixelRatio = (static_cast<float>(outputWidth) * outputHeight) / (static_cast<float>(renderWidth) * renderHeight);
+		m_phaseCount = settings.jitterPhaseCount ? settings.jitterPhaseCount : static_cast<uint32_t>(std::ceil(8.0f * pixelRatio));
+
+		if (outputWidth != m_outputWidth || outputHeight != m_outputHeight)
+		{
+			m_outputWidth = outputWidth;
+			m_outputHeight = outputHeight;
+			for (std::vector<Math::Float4>& history : m_history)
+				history.assign(size_t(outputWidth) * outputHeight, Math::Float4{ 0.0f, 0.0f, 0.0f, 0.0f });
+			m_historyValid = false;
+		}
+	}
+
+	void TemporalUpscaler::BeginFrame(uint64_t frameIndex) noexcept
+	{
+		m_jitter = ComputeJitter(frameIndex, m_phaseCount);
+	}
+
+	void TemporalUpscaler::Resolve(const Math::Float4* color, const float* motion, Math::Float4* output)
+	{
+		const int renderWidth = m_renderWidth;
+		const int renderHeight = m_renderHeight;
+		const int outputWidth = m_outputWidth;
+		const int outputHeight = m_outputHeight;
+		const float toRenderX = static_cast<float>(renderWidth) / outputWidth;
+		const float toRenderY = static_cast<float>(renderHeight) / outputHeight;
+
+		const Math::Float4* history = m_history[m_readHistory].data();
+		Math::Float4* accumulated = m_history[1 - m_readHistory].data();
+		const bool historyValid = m_historyValid;
+
+		Parallel::ParallelFor(size_t(outputHeight), ResolveGrainSize, [&](size_t rowBegin, size_t rowEnd)
+		{
+			for (size_t y = rowBegin; y < rowEnd; y++)
+			{
+				const float v = (static_cast<float>(y) + 0.5f) / outputHeight;
+				for (int x = 0; x < outputWidth; x++)
+				{
+					const float u = (static_cast<float>(x) + 0.5f) / outputWidth;
+
+					// Position of the output pixel in the render target's sample grid. ApplyJitter moved the scene by +jitter, so the sample that saw this point is offset by the same amount
+					const float renderX = u * renderWidth - 0.5f + m_jitter.x;
+					const float renderY = v * renderHeight - 0.5f + m_jitter.y;
+					const int sampleX = std::clamp(static_cast<int>(std::lround(renderX)), 0, renderWidth - 1);
+					const int sampleY = std::clamp(static_cast<int>(std::lround(renderY)), 0, renderHeight - 1);
+					const size_t sample = size_t(sampleY) * renderWidth + sampleX;
+
+					const Pixel current = Pixel::Load(color[sample]);
+					Pixel result = current;
+
+					const float previousU = u + motion[sample * 2];
+					const float previousV = v + motion[sample * 2 + 1];
+					if (historyValid && previousU >= 0.0f && previousU <= 1.0f && previousV >= 0.0f && previousV <= 1.0f)
+					{
+						// Neighbourhood of the current sample bounds what the history may contain, rejecting stale and disoccluded history
+						Pixel minimum = current;
+						Pixel maximum = current;
+						for (int dy = -1; dy <= 1; dy++)
+						{
+							const int ny = std::clamp(sampleY + dy, 0, renderHeight - 1);
+							for (int dx = -1; dx <= 1; dx++)
+							{
+								const int nx = std::clamp(sampleX + dx, 0, renderWidth - 1);
+								const Pixel neighbour = Pixel::Load(color[size_t(ny) * renderWidth + nx]);
+								minimum = Min(minimum, neighbour);
+								maximum = Max(maximum, neighbour);
+							}
+						}
+
+						const Pixel previous = SIMD::SampleBilinear(history, outputWidth, outputHeight, previousU * outputWidth - 0.5f, previousV * outputHeight - 0.5f);
+						const Pixel clamped = Min(Max(previous, minimum), maximum);
+
+						// Samples far from the output pixel (in output pixels) contribute less
+						const float distanceX = (renderX - sampleX) / toRenderX;
+						const float distanceY = (renderY - sampleY) / toRenderY;
+						const float weight = std::exp(-SampleFalloff * (distanceX * distanceX + distanceY * distanceY));
+
+						result = Lerp(clamped, current, m_settings.blendFactor * weight);
+					}
+
+					result.Store(accumulated[y * outputWidth + x]);
+					result.Store(output[y * outputWidth + x]);
+				}
+			}
+		});
+
+		m_readHistory = 1 - m_readHistory;
+		m_historyValid = true;
+	}
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <TemporalUpscaler.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	constexpr uint16_t RenderWidth = 16;
+	constexpr uint16_t RenderHeight = 16;
+	constexpr uint16_t OutputWidth = 32;
+	constexpr uint16_t OutputHeight = 32;
+
+	// Position of the impulse in unjittered render target pixels
+	constexpr float ImpulseX = 8.3f;
+	constexpr float ImpulseY = 7.6f;
+
+	// The render pixel holding the impulse is up to half a render pixel off, and the output pixels that pick it up add half an output pixel
+	constexpr float CentreTolerance = 0.5f + 0.5f * RenderWidth / OutputWidth + 1e-3f;
+
+	struct Point
+	{
+		float x;
+		float y;
+	};
+
+	// Rasterize the impulse through a jittered identity projection, like the renderer would
+	std::vector<Math::Float4> RenderImpulse(const JitterOffset& jitter)
+	{
+		Math::Float4x4 projection = Math::Float4x4::Identity;
+		TemporalUpscaler::ApplyJitter(projection, jitter, RenderWidth, RenderHeight);
+
+		const float ndcX = 2.0f * ImpulseX / RenderWidth - 1.0f;
+		const float ndcY = 1.0f - 2.0f * ImpulseY / RenderHeight;
+		const float clipX = ndcX * projection.m[0][0] + ndcY * projection.m[1][0] + projection.m[3][0];
+		const float clipY = ndcX * projection.m[0][1] + ndcY * projection.m[1][1] + projection.m[3][1];
+		const float clipW = ndcX * projection.m[0][3] + ndcY * projection.m[1][3] + projection.m[3][3];
+
+		const int pixelX = static_cast<int>(std::floor((clipX / clipW * 0.5f + 0.5f) * RenderWidth));
+		const int pixelY = static_cast<int>(std::floor((0.5f - clipY / clipW * 0.5f) * RenderHeight));
+
+		std::vector<Math::Float4> color(size_t(RenderWidth) * RenderHeight, Math::Float4{ 0.0f, 0.0f, 0.0f, 1.0f });
+		color[size_t(pixelY) * RenderWidth + pixelX] = Math::Float4{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+		return color;
+	}
+
+	// Intensity weighted centre of the output, in render target pixels
+	Point Centroid(const std::vector<Math::Float4>& output)
+	{
+		float total = 0.0f;
+		float x = 0.0f;
+		float y = 0.0f;
+		for (size_t row = 0; row < OutputHeight; row++)
+		{
+			for (size_t column = 0; column < OutputWidth; column++)
+			{
+				const float value = output[row * OutputWidth + column].x;
+				total += value;
+				x += value * (column + 0.5f);
+				y += value * (row + 0.5f);
+			}
+		}
+
+		return Point{ x / total * RenderWidth / OutputWidth, y / total * RenderHeight / OutputHeight };
+	}
+
+	class TemporalUpscalerTests : public ::testing::Test
+	{
+	protected:
+		TemporalUpscaler m_upscaler;
+		std::vector<float> m_motion = std::vector<float>(size_t(RenderWidth) * RenderHeight * 2, 0.0f);
+		std::vector<Math::Float4> m_output = std::vector<Math::Float4>(size_t(OutputWidth) * OutputHeight);
+
+		void SetUp() override
+		{
+			m_upscaler.Configure(TemporalUpscaleSettings{}, RenderWidth, RenderHeight, OutputWidth, OutputHeight);
+		}
+
+		void ResolveFrame(uint64_t frameIndex)
+		{
+			m_upscaler.BeginFrame(frameIndex);
+			const std::vector<Math::Float4> color = RenderImpulse(m_upscaler.GetJitter());
+			m_upscaler.Resolve(color.data(), m_motion.data(), m_output.data());
+		}
+	};
+}
+
+TEST(TemporalUpscalerJitter, ApplyJitterMovesSamplesByJitter)
+{
+	Math::Float4x4 projection = Math::Float4x4::Identity;
+	TemporalUpscaler::ApplyJitter(projection, JitterOffset{ 0.25f, -0.5f }, RenderWidth, RenderHeight);
+
+	// The center of the screen moves right and up in render target pixels
+	EXPECT_FLOAT_EQ(projection.m[3][0] * 0.5f * RenderWidth, 0.25f);
+	EXPECT_FLOAT_EQ(-projection.m[3][1] * 0.5f * RenderHeight, -0.5f);
+}
+
+TEST(TemporalUpscalerJitter, SequenceStaysInsidePixel)
+{
+	for (uint64_t frame = 0; frame < 64; frame++)
+	{
+		const JitterOffset jitter = TemporalUpscaler::ComputeJitter(frame, 16);
+		EXPECT_GE(jitter.x, -0.5f);
+		EXPECT_LT(jitter.x, 0.5f);
+		EXPECT_GE(jitter.y, -0.5f);
+		EXPECT_LT(jitter.y, 0.5f);
+	}
+}
+
+TEST_F(TemporalUpscalerTests, JitteredImpulseStaysCentredWithoutHistory)
+{
+	for (uint64_t frame = 0; frame < 16; frame++)
+	{
+		m_upscaler.ResetHistory();
+		ResolveFrame(frame);
+
+		const Point centre = Centroid(m_output);
+		EXPECT_NEAR(centre.x, ImpulseX, CentreTolerance) << "frame " << frame;
+		EXPECT_NEAR(centre.y, ImpulseY, CentreTolerance) << "frame " << frame;
+	}
+}
+
+TEST_F(TemporalUpscalerTests, JitteredImpulseStaysCentredWhileAccumulating)
+{
+	for (uint64_t frame = 0; frame < 64; frame++)
+	{
+		ResolveFrame(frame);
+
+		const Point centre = Centroid(m_output);
+		EXPECT_NEAR(centre.x, ImpulseX, CentreTolerance) << "frame " << frame;
+		EXPECT_NEAR(centre.y, ImpulseY, CentreTolerance) << "frame " << frame;
+	}
+}
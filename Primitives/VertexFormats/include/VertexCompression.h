@@ -0,0 +1,102 @@
+#ifndef ULTREALITY_RENDERING_VERTEX_COMPRESSION_H
+#define ULTREALITY_RENDERING_VERTEX_COMPRESSION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <Primitives.h>
+#include <VertexLayout.h>
+
+namespace UltReality::Rendering
+{
+	struct PackedVertex
+	{
+		int16_t pos[4];	// snorm16 position relative to the mesh VertexBounds, w is unused
+		uint32_t color;	// RGBA8 unorm color
+	};
+	static_assert(sizeof(PackedVertex) == 12, "PackedVertex must match VertexLayout::Packed()");
+
+	struct PackedVertexHalf
+	{
+		uint16_t pos[4];	// Half float position, w is unused
+		uint32_t color;		// RGBA8 unorm color
+	};
+	static_assert(sizeof(PackedVertexHalf) == 12, "PackedVertexHalf must match VertexLayout::PackedHalf()");
+
+	namespace VertexCompression
+	{
+		/// <summary>
+		/// Convert a 32-bit float to a 16-bit IEEE half float, rounding to nearest even
+		/// </summary>
+		uint16_t FloatToHalf(float value) noexcept;
+
+		/// <summary>
+		/// Convert a 16-bit IEEE half float to a 32-bit float
+		/// </summary>
+		float HalfToFloat(uint16_t value) noexcept;
+
+		/// <summary>
+		/// Pack a color with components in the range [0, 1] into RGBA8 unorm, R in the lowest byte
+		/// </summary>
+		uint32_t PackRGBA8(const Math::Float4& color) noexcept;
+
+		/// <summary>
+		/// Unpack an RGBA8 unorm color into floats in the range [0, 1]
+		/// </summary>
+		Math::Float4 UnpackRGBA8(uint32_t color) noexcept;
+
+		/// <summary>
+		/// Encode a unit vector with octahedral mapping into two snorm16 values, x in the low 16 bits
+		/// </summary>
+		uint32_t OctEncode(const Math::Float3& normal) noexcept;
+
+		/// <summary>
+		/// Decode an octahedral encoded unit vector
+		/// </summary>
+		Math::Float3 OctDecode(uint32_t encoded) noexcept;
+
+		/// <summary>
+		/// Compute the quantization bounds of a set of vertices
+		/// </summary>
+		/// <param name="vertices">Vertices to compute the bounds of</param>
+		/// <param name="count">Number of vertices</param>
+		/// <returns>Bounds enclosing every vertex position. Degenerate axes are given a non-zero extent so they can be decoded</returns>
+		VertexBounds ComputeBounds(const Vertex* vertices, size_t count) noexcept;
+
+		/// <summary>
+		/// Batch encode full precision vertices into the snorm16 <see cref="PackedVertex"/> format
+		/// </summary>
+		/// <param name="src">Vertices to encode</param>
+		/// <param name="count">Number of vertices</param>
+		/// <param name="bounds">Bounds to quantize positions against, typically from <see cref="ComputeBounds"/></param>
+		/// <param name="dst">Destination, must hold count vertices</param>
+		void EncodeVertices(const Vertex* src, size_t count, const VertexBounds& bounds, PackedVertex* dst) noexcept;
+
+		/// <summary>
+		/// Batch decode <see cref="PackedVertex"/> vertices back to full precision
+		/// </summary>
+		void DecodeVertices(const PackedVertex* src, size_t count, const VertexBounds& bounds, Vertex* dst) noexcept;
+
+		/// <summary>
+		/// Batch encode full precision vertices into the half float <see cref="PackedVertexHalf"/> format
+		/// </summary>
+		void EncodeVertices(const Vertex* src, size_t count, PackedVertexHalf* dst) noexcept;
+
+		/// <summary>
+		/// Batch decode <see cref="PackedVertexHalf"/> vertices back to full precision
+		/// </summary>
+		void DecodeVertices(const PackedVertexHalf* src, size_t count, Vertex* dst) noexcept;
+
+		/// <summary>
+		/// Batch octahedral encode unit vectors, see <see cref="OctEncode"/>
+		/// </summary>
+		void EncodeNormals(const Math::Float3* src, size_t count, uint32_t* dst) noexcept;
+
+		/// <summary>
+		/// Batch decode octahedral encoded unit vectors, see <see cref="OctDecode"/>
+		/// </summary>
+		void DecodeNormals(const uint32_t* src, size_t count, Math::Float3* dst) noexcept;
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_VERTEX_COMPRESSION_H
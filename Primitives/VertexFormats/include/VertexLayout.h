@@ -0,0 +1,194 @@
+#ifndef ULTREALITY_RENDERING_VERTEX_LAYOUT_H
+#define ULTREALITY_RENDERING_VERTEX_LAYOUT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include <stdexcept>
+
+#include <Primitives.h>
+
+namespace UltReality::Rendering
+{
+	enum class VertexSemantic : uint8_t
+	{
+		Position,
+		Normal,
+		Tangent,
+		Color,
+		TexCoord
+	};
+
+	enum class VertexFormat : uint8_t
+	{
+		Float2,		// 2x 32-bit float. 8 bytes
+		Float3,		// 3x 32-bit float. 12 bytes
+		Float4,		// 4x 32-bit float. 16 bytes
+		Half2,		// 2x 16-bit IEEE half float. 4 bytes
+		Half4,		// 4x 16-bit IEEE half float. 8 bytes
+		SNorm16x2,	// 2x 16-bit signed normalized. 4 bytes (octahedral normals/tangents)
+		SNorm16x4,	// 4x 16-bit signed normalized. 8 bytes (positions relative to the mesh bounds)
+		RGBA8UNorm	// 4x 8-bit unsigned normalized. 4 bytes
+	};
+
+	/// <summary>
+	/// Get the number of bytes a single element of a <see cref="VertexFormat"/> occupies
+	/// </summary>
+	/// <param name="format">The format to get the size of</param>
+	/// <returns>Size of the format in bytes</returns>
+	constexpr uint16_t VertexFormatSize(VertexFormat format) noexcept
+	{
+		switch (format)
+		{
+		case VertexFormat::Float2:		return 8;
+		case VertexFormat::Float3:		return 12;
+		case VertexFormat::Float4:		return 16;
+		case VertexFormat::Half2:		return 4;
+		case VertexFormat::Half4:		return 8;
+		case VertexFormat::SNorm16x2:	return 4;
+		case VertexFormat::SNorm16x4:	return 8;
+		case VertexFormat::RGBA8UNorm:	return 4;
+		}
+
+		return 0;
+	}
+
+	/// <summary>
+	/// Axis aligned bounds that quantized positions are stored relative to. A position is encoded as (pos - center) / extent
+	/// </summary>
+	struct VertexBounds
+	{
+		Math::Float3 center;
+		Math::Float3 extent; // Half size of the bounds on each axis
+	};
+
+	struct VertexAttribute
+	{
+		VertexSemantic semantic;
+		uint8_t semanticIndex;	// Distinguishes multiple attributes of the same semantic (TEXCOORD0, TEXCOORD1...)
+		VertexFormat format;
+		uint16_t offset;		// Byte offset of the attribute from the start of the vertex
+	};
+
+	/// <summary>
+	/// Describes how the attributes of a single vertex are laid out in a vertex buffer so renderers can build their input layouts
+	/// </summary>
+	class VertexLayout
+	{
+	public:
+		static constexpr size_t MaxAttributes = 8;
+
+	protected:
+		std::array<VertexAttribute, MaxAttributes> m_attributes{};
+		uint8_t m_attributeCount = 0;
+		uint16_t m_stride = 0;
+		VertexBounds m_positionBounds{ { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+
+	public:
+		/// <summary>
+		/// Append an attribute to the end of the layout. Attributes are tightly packed in the order they are added
+		/// </summary>
+		/// <param name="semantic">What the attribute represents</param>
+		/// <param name="format">How the attribute is stored</param>
+		/// <param name="semanticIndex">Index to distinguish attributes that share a semantic</param>
+		/// <returns>Reference to this layout so calls can be chained</returns>
+		/// <exception cref="std.out_of_range">Thrown if the layout already holds <see cref="MaxAttributes"/> attributes. In a constant expression this is a compile error</exception>
+		constexpr VertexLayout& Add(VertexSemantic semantic, VertexFormat format, uint8_t semanticIndex = 0)
+		{
+			if (m_attributeCount >= MaxAttributes)
+				throw std::out_of_range("VertexLayout can not hold more than MaxAttributes attributes");
+
+			m_attributes[m_attributeCount++] = VertexAttribute{ semantic, semanticIndex, format, m_stride };
+			m_stride += VertexFormatSize(format);
+
+			return *this;
+		}
+
+		/// <summary>
+		/// Set the bounds that normalized position formats are decoded against, position = center + value * extent.
+		/// Float and half positions ignore the bounds
+		/// </summary>
+		/// <returns>Reference to this layout so calls can be chained</returns>
+		constexpr VertexLayout& SetPositionBounds(const VertexBounds& bounds) noexcept
+		{
+			m_positionBounds = bounds;
+
+			return *this;
+		}
+
+		/// <summary>
+		/// Get the bounds that normalized position formats are decoded against. Defaults to a unit cube at the origin
+		/// </summary>
+		constexpr const VertexBounds& GetPositionBounds() const noexcept
+		{
+			return m_positionBounds;
+		}
+
+		/// <summary>
+		/// Get the number of bytes between consecutive vertices
+		/// </summary>
+		constexpr uint16_t GetStride() const noexcept
+		{
+			return m_stride;
+		}
+
+		/// <summary>
+		/// Get the number of attributes in the layout
+		/// </summary>
+		constexpr size_t GetAttributeCount() const noexcept
+		{
+			return m_attributeCount;
+		}
+
+		/// <summary>
+		/// Get an attribute of the layout
+		/// </summary>
+		/// <param name="index">Index of the attribute, in the order they were added</param>
+		constexpr const VertexAttribute& GetAttribute(size_t index) const noexcept
+		{
+			return m_attributes[index];
+		}
+
+		/// <summary>
+		/// Find the first attribute with the requested semantic
+		/// </summary>
+		/// <returns>Pointer to the attribute, nullptr if the layout does not contain it</returns>
+		constexpr const VertexAttribute* Find(VertexSemantic semantic, uint8_t semanticIndex = 0) const noexcept
+		{
+			for (size_t i = 0; i < m_attributeCount; i++)
+			{
+				if (m_attributes[i].semantic == semantic && m_attributes[i].semanticIndex == semanticIndex)
+					return &m_attributes[i];
+			}
+
+			return nullptr;
+		}
+
+		/// <summary>
+		/// Layout of the full precision <see cref="Vertex"/> structure. 28 bytes
+		/// </summary>
+		static constexpr VertexLayout Standard() noexcept
+		{
+			return VertexLayout().Add(VertexSemantic::Position, VertexFormat::Float3).Add(VertexSemantic::Color, VertexFormat::Float4);
+		}
+
+		/// <summary>
+		/// Layout of the <see cref="PackedVertex"/> structure. 12 bytes
+		/// </summary>
+		/// <param name="bounds">Bounds the snorm16 positions were encoded against, see <see cref="VertexCompression::EncodeVertices"/></param>
+		static constexpr VertexLayout Packed(const VertexBounds& bounds) noexcept
+		{
+			return VertexLayout().Add(VertexSemantic::Position, VertexFormat::SNorm16x4).Add(VertexSemantic::Color, VertexFormat::RGBA8UNorm).SetPositionBounds(bounds);
+		}
+
+		/// <summary>
+		/// Layout of the <see cref="PackedVertexHalf"/> structure. Positions are half floats, no bounds are needed to decode. 12 bytes
+		/// </summary>
+		static constexpr VertexLayout PackedHalf() noexcept
+		{
+			return VertexLayout().Add(VertexSemantic::Position, VertexFormat::Half4).Add(VertexSemantic::Color, VertexFormat::RGBA8UNorm);
+		}
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_VERTEX_LAYOUT_H
@@ -0,0 +1,383 @@
+#include <VertexCompression.h>
+#include <RenderingSIMD.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace UltReality::Rendering::VertexCompression
+{
+	namespace
+	{
+		constexpr float SNorm16Scale = 32767.0f;
+		constexpr float UNorm8Scale = 255.0f;
+
+		// Degenerate axes (flat meshes) still need a non-zero extent so the reciprocal is finite
+		constexpr float MinimumExtent = 1e-6f;
+
+		inline uint32_t AsUInt(float value) noexcept
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+
+		inline float AsFloat(uint32_t bits) noexcept
+		{
+			float value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		inline int16_t ToSNorm16(float value) noexcept
+		{
+			return static_cast<int16_t>(std::nearbyint(std::clamp(value, -1.0f, 1.0f) * SNorm16Scale));
+		}
+
+		inline float FromSNorm16(int16_t value) noexcept
+		{
+			return std::max(static_cast<float>(value) / SNorm16Scale, -1.0f);
+		}
+
+		inline float SignNotZero(float value) noexcept
+		{
+			return value >= 0.0f ? 1.0f : -1.0f;
+		}
+	}
+
+	uint16_t FloatToHalf(float value) noexcept
+	{
+		uint32_t bits = AsUInt(value);
+		const uint32_t sign = bits & 0x80000000u;
+		bits ^= sign;
+
+		uint16_t half;
+		if (bits >= 0x47800000u) // Too large for a half, becomes Inf (or stays NaN)
+		{
+			half = (bits > 0x7f800000u) ? 0x7e00 : 0x7c00;
+		}
+		else if (bits < 0x38800000u) // Half subnormal or zero. Let the FPU round the mantissa into place
+		{
+			constexpr uint32_t denormMagic = 126u << 23;
+			half = static_cast<uint16_t>(AsUInt(AsFloat(bits) + AsFloat(denormMagic)) - denormMagic);
+		}
+		else // Normal half. Re-bias the exponent and round the mantissa to nearest even
+		{
+			const uint32_t mantissaOdd = (bits >> 13) & 1u;
+			bits += 0xc8000fffu; // ((15 - 127) << 23) + 0xfff
+			bits += mantissaOdd;
+			half = static_cast<uint16_t>(bits >> 13);
+		}
+
+		return static_cast<uint16_t>((sign >> 16) | half);
+	}
+
+	float HalfToFloat(uint16_t value) noexcept
+	{
+		constexpr uint32_t shiftedExponent = 0x7c00u << 13;
+		constexpr uint32_t magic = 113u << 23;
+
+		uint32_t bits = (value & 0x7fffu) << 13;
+		const uint32_t exponent = bits & shiftedExponent;
+		bits += (127u - 15u) << 23;
+
+		if (exponent == shiftedExponent) // Inf or NaN
+		{
+			bits += (128u - 16u) << 23;
+		}
+		else if (exponent == 0) // Zero or subnormal, renormalize
+		{
+			bits += 1u << 23;
+			bits = AsUInt(AsFloat(bits) - AsFloat(magic));
+		}
+
+		bits |= static_cast<uint32_t>(value & 0x8000u) << 16;
+
+		return AsFloat(bits);
+	}
+
+	uint32_t PackRGBA8(const Math::Float4& color) noexcept
+	{
+		const auto toUNorm8 = [](float c) noexcept
+		{
+			return static_cast<uint32_t>(std::nearbyint(std::clamp(c, 0.0f, 1.0f) * UNorm8Scale));
+		};
+
+		return toUNorm8(color.x) | (toUNorm8(color.y) << 8) | (toUNorm8(color.z) << 16) | (toUNorm8(color.w) << 24);
+	}
+
+	Math::Float4 UnpackRGBA8(uint32_t color) noexcept
+	{
+		return Math::Float4{
+			static_cast<float>(color & 0xffu) / UNorm8Scale,
+			static_cast<float>((color >> 8) & 0xffu) / UNorm8Scale,
+			static_cast<float>((color >> 16) & 0xffu) / UNorm8Scale,
+			static_cast<float>((color >> 24) & 0xffu) / UNorm8Scale
+		};
+	}
+
+	uint32_t OctEncode(const Math::Float3& normal) noexcept
+	{
+		const float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (l1 <= 0.0f)
+			return 0;
+
+		float x = normal.x / l1;
+		float y = normal.y / l1;
+
+		// Fold the lower hemisphere over the diagonals
+		if (normal.z < 0.0f)
+		{
+			const float foldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+			const float foldedY = (1.0f - std::abs(x)) * SignNotZero(y);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		return static_cast<uint16_t>(ToSNorm16(x)) | (static_cast<uint32_t>(static_cast<uint16_t>(ToSNorm16(y))) << 16);
+	}
+
+	Math::Float3 OctDecode(uint32_t encoded) noexcept
+	{
+		float x = FromSNorm16(static_cast<int16_t>(encoded & 0xffffu));
+		float y = FromSNorm16(static_cast<int16_t>(encoded >> 16));
+		float z = 1.0f - std::abs(x) - std::abs(y);
+
+		// Unfold the lower hemisphere
+		const float t = std::max(-z, 0.0f);
+		x += (x >= 0.0f) ? -t : t;
+		y += (y >= 0.0f) ? -t : t;
+
+		const float length = std::sqrt(x * x + y * y + z * z);
+		if (length <= 0.0f)
+			return Math::Float3{ 0.0f, 0.0f, 1.0f };
+
+		return Math::Float3{ x / length, y / length, z / length };
+	}
+
+	VertexBounds ComputeBounds(const Vertex* vertices, size_t count) noexcept
+	{
+		if (count == 0)
+			return VertexBounds{ { 0.0f, 0.0f, 0.0f }, { MinimumExtent, MinimumExtent, MinimumExtent } };
+
+		Math::Float3 minimum = vertices[0].pos;
+		Math::Float3 maximum = vertices[0].pos;
+		for (size_t i = 1; i < count; i++)
+		{
+			const Math::Float3& p = vertices[i].pos;
+			minimum = Math::Float3{ std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+			maximum = Math::Float3{ std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+		}
+
+		return VertexBounds{
+			{ (minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f },
+			{
+				std::max((maximum.x - minimum.x) * 0.5f, MinimumExtent),
+				std::max((maximum.y - minimum.y) * 0.5f, MinimumExtent),
+				std::max((maximum.z - minimum.z) * 0.5f, MinimumExtent)
+			}
+		};
+	}
+
+	void EncodeVertices(const Vertex* src, size_t count, const VertexBounds& bounds, PackedVertex* dst) noexcept
+	{
+		const Math::Float3 invExtent{ 1.0f / bounds.extent.x, 1.0f / bounds.extent.y, 1.0f / bounds.extent.z };
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+		const __m128 center = _mm_set_ps(0.0f, bounds.center.z, bounds.center.y, bounds.center.x);
+		const __m128 scale = _mm_set_ps(0.0f, invExtent.z, invExtent.y, invExtent.x);
+		const __m128 negOne = _mm_set1_ps(-1.0f);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 snormScale = _mm_set1_ps(SNorm16Scale);
+		const __m128 unormScale = _mm_set1_ps(UNorm8Scale);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const Vertex& v = src[i];
+
+			__m128 p = _mm_set_ps(0.0f, v.pos.z, v.pos.y, v.pos.x);
+			p = _mm_mul_ps(_mm_sub_ps(p, center), scale);
+			p = _mm_min_ps(_mm_max_ps(p, negOne), one);
+			const __m128i pi = _mm_cvtps_epi32(_mm_mul_ps(p, snormScale));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(dst[i].pos), _mm_packs_epi32(pi, pi));
+
+			__m128 c = _mm_set_ps(v.color.w, v.color.z, v.color.y, v.color.x);
+			c = _mm_min_ps(_mm_max_ps(c, zero), one);
+			__m128i ci = _mm_cvtps_epi32(_mm_mul_ps(c, unormScale));
+			ci = _mm_packs_epi32(ci, ci);
+			ci = _mm_packus_epi16(ci, ci);
+			dst[i].color = static_cast<uint32_t>(_mm_cvtsi128_si32(ci));
+		}
+#else
+		for (size_t i = 0; i < count; i++)
+		{
+			const Vertex& v = src[i];
+
+			dst[i].pos[0] = ToSNorm16((v.pos.x - bounds.center.x) * invExtent.x);
+			dst[i].pos[1] = ToSNorm16((v.pos.y - bounds.center.y) * invExtent.y);
+			dst[i].pos[2] = ToSNorm16((v.pos.z - bounds.center.z) * invExtent.z);
+			dst[i].pos[3] = 0;
+			dst[i].color = PackRGBA8(v.color);
+		}
+#endif
+	}
+
+	void DecodeVertices(const PackedVertex* src, size_t count, const VertexBounds& bounds, Vertex* dst) noexcept
+	{
+#if defined(ULTREALITY_RENDERING_SSE2)
+		const __m128 center = _mm_set_ps(0.0f, bounds.center.z, bounds.center.y, bounds.center.x);
+		const __m128 extent = _mm_set_ps(0.0f, bounds.extent.z, bounds.extent.y, bounds.extent.x);
+		const __m128 negOne = _mm_set1_ps(-1.0f);
+		const __m128 invSNorm = _mm_set1_ps(1.0f / SNorm16Scale);
+		const __m128 invUNorm = _mm_set1_ps(1.0f / UNorm8Scale);
+		const __m128i zero = _mm_setzero_si128();
+
+		alignas(16) float pos[4];
+		for (size_t i = 0; i < count; i++)
+		{
+			__m128i pi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src[i].pos));
+			pi = _mm_srai_epi32(_mm_unpacklo_epi16(pi, pi), 16); // Sign extend to 32-bit
+			__m128 p = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(pi), invSNorm), negOne);
+			p = _mm_add_ps(_mm_mul_ps(p, extent), center);
+			_mm_store_ps(pos, p);
+			dst[i].pos = Math::Float3{ pos[0], pos[1], pos[2] };
+
+			__m128i ci = _mm_cvtsi32_si128(static_cast<int>(src[i].color));
+			ci = _mm_unpacklo_epi16(_mm_unpacklo_epi8(ci, zero), zero);
+			_mm_store_ps(pos, _mm_mul_ps(_mm_cvtepi32_ps(ci), invUNorm));
+			dst[i].color = Math::Float4{ pos[0], pos[1], pos[2], pos[3] };
+		}
+#else
+		for (size_t i = 0; i < count; i++)
+		{
+			dst[i].pos = Math::Float3{
+				FromSNorm16(src[i].pos[0]) * bounds.extent.x + bounds.center.x,
+				FromSNorm16(src[i].pos[1]) * bounds.extent.y + bounds.center.y,
+				FromSNorm16(src[i].pos[2]) * bounds.extent.z + bounds.center.z
+			};
+			dst[i].color = UnpackRGBA8(src[i].color);
+		}
+#endif
+	}
+
+	void EncodeVertices(const Vertex* src, size_t count, PackedVertexHalf* dst) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const Vertex& v = src[i];
+
+#if defined(ULTREALITY_RENDERING_F16C)
+			const __m128i h = _mm_cvtps_ph(_mm_set_ps(0.0f, v.pos.z, v.pos.y, v.pos.x), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(dst[i].pos), h);
+#else
+			dst[i].pos[0] = FloatToHalf(v.pos.x);
+			dst[i].pos[1] = FloatToHalf(v.pos.y);
+			dst[i].pos[2] = FloatToHalf(v.pos.z);
+			dst[i].pos[3] = 0;
+#endif
+			dst[i].color = PackRGBA8(v.color);
+		}
+	}
+
+	void DecodeVertices(const PackedVertexHalf* src, size_t count, Vertex* dst) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+#if defined(ULTREALITY_RENDERING_F16C)
+			alignas(16) float pos[4];
+			_mm_store_ps(pos, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src[i].pos))));
+			dst[i].pos = Math::Float3{ pos[0], pos[1], pos[2] };
+#else
+			dst[i].pos = Math::Float3{ HalfToFloat(src[i].pos[0]), HalfToFloat(src[i].pos[1]), HalfToFloat(src[i].pos[2]) };
+#endif
+			dst[i].color = UnpackRGBA8(src[i].color);
+		}
+	}
+
+	void EncodeNormals(const Math::Float3* src, size_t count, uint32_t* dst) noexcept
+	{
+		size_t i = 0;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+		// Process 4 normals at a time in SoA form
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 negOne = _mm_set1_ps(-1.0f);
+		const __m128 snormScale = _mm_set1_ps(SNorm16Scale);
+		const __m128i lowMask = _mm_set1_epi32(0xffff);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 x = _mm_set_ps(src[i + 3].x, src[i + 2].x, src[i + 1].x, src[i].x);
+			const __m128 y = _mm_set_ps(src[i + 3].y, src[i + 2].y, src[i + 1].y, src[i].y);
+			const __m128 z = _mm_set_ps(src[i + 3].z, src[i + 2].z, src[i + 1].z, src[i].z);
+
+			const __m128 l1 = _mm_add_ps(_mm_add_ps(_mm_and_ps(x, absMask), _mm_and_ps(y, absMask)), _mm_and_ps(z, absMask));
+			const __m128 invL1 = _mm_and_ps(_mm_div_ps(one, l1), _mm_cmpgt_ps(l1, zero)); // Zero length vectors encode as 0
+			__m128 ox = _mm_mul_ps(x, invL1);
+			__m128 oy = _mm_mul_ps(y, invL1);
+
+			// Fold the lower hemisphere over the diagonals
+			const __m128 signX = _mm_or_ps(_mm_and_ps(_mm_cmpge_ps(ox, zero), one), _mm_andnot_ps(_mm_cmpge_ps(ox, zero), negOne));
+			const __m128 signY = _mm_or_ps(_mm_and_ps(_mm_cmpge_ps(oy, zero), one), _mm_andnot_ps(_mm_cmpge_ps(oy, zero), negOne));
+			const __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(oy, absMask)), signX);
+			const __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(ox, absMask)), signY);
+			const __m128 lower = _mm_cmplt_ps(z, zero);
+			ox = _mm_or_ps(_mm_and_ps(lower, foldedX), _mm_andnot_ps(lower, ox));
+			oy = _mm_or_ps(_mm_and_ps(lower, foldedY), _mm_andnot_ps(lower, oy));
+
+			ox = _mm_mul_ps(_mm_min_ps(_mm_max_ps(ox, negOne), one), snormScale);
+			oy = _mm_mul_ps(_mm_min_ps(_mm_max_ps(oy, negOne), one), snormScale);
+
+			const __m128i packed = _mm_or_si128(_mm_and_si128(_mm_cvtps_epi32(ox), lowMask), _mm_slli_epi32(_mm_cvtps_epi32(oy), 16));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+		}
+#endif
+
+		for (; i < count; i++)
+			dst[i] = OctEncode(src[i]);
+	}
+
+	void DecodeNormals(const uint32_t* src, size_t count, Math::Float3* dst) noexcept
+	{
+		size_t i = 0;
+
+#if defined(ULTREALITY_RENDERING_SSE2)
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 negOne = _mm_set1_ps(-1.0f);
+		const __m128 invSNorm = _mm_set1_ps(1.0f / SNorm16Scale);
+
+		alignas(16) float xs[4];
+		alignas(16) float ys[4];
+		alignas(16) float zs[4];
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			__m128 x = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(packed, 16), 16)), invSNorm), negOne);
+			__m128 y = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(packed, 16)), invSNorm), negOne);
+			__m128 z = _mm_sub_ps(_mm_sub_ps(one, _mm_and_ps(x, absMask)), _mm_and_ps(y, absMask));
+
+			// Unfold the lower hemisphere, moving x and y towards zero by t
+			const __m128 t = _mm_max_ps(_mm_sub_ps(zero, z), zero);
+			x = _mm_sub_ps(x, _mm_or_ps(t, _mm_and_ps(x, signMask)));
+			y = _mm_sub_ps(y, _mm_or_ps(t, _mm_and_ps(y, signMask)));
+
+			const __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z))));
+			_mm_store_ps(xs, _mm_mul_ps(x, invLength));
+			_mm_store_ps(ys, _mm_mul_ps(y, invLength));
+			_mm_store_ps(zs, _mm_mul_ps(z, invLength));
+
+			for (size_t lane = 0; lane < 4; lane++)
+				dst[i + lane] = Math::Float3{ xs[lane], ys[lane], zs[lane] };
+		}
+#endif
+
+		for (; i < count; i++)
+			dst[i] = OctDecode(src[i]);
+	}
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <VertexCompression.h>
+#include <VertexLayout.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	// Half an RGBA8 step, plus float rounding
+	constexpr float ColorTolerance = 0.5f / 255.0f + 1e-6f;
+
+	float AsFloat(uint32_t bits)
+	{
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	std::vector<Vertex> MakeVertices()
+	{
+		std::vector<Vertex> vertices;
+		for (size_t i = 0; i < 257; i++)
+		{
+			const float t = static_cast<float>(i) / 256.0f;
+			vertices.push_back(Vertex{
+				Math::Float3{ -40.0f + 90.0f * t, 3.0f * std::sin(t * 20.0f), 12.5f - 0.25f * t },
+				Math::Float4{ t, 1.0f - t, 0.5f, (i % 2) ? 1.0f : 0.0f }
+			});
+		}
+
+		return vertices;
+	}
+}
+
+TEST(VertexCompression, HalfRoundTripsEveryHalfValue)
+{
+	for (uint32_t half = 0; half <= 0xffffu; half++)
+	{
+		// NaNs keep their sign and stay NaN, but not every payload survives the float
+		if ((half & 0x7c00u) == 0x7c00u && (half & 0x03ffu) != 0)
+		{
+			EXPECT_TRUE(std::isnan(VertexCompression::HalfToFloat(static_cast<uint16_t>(half))));
+			continue;
+		}
+
+		ASSERT_EQ(VertexCompression::FloatToHalf(VertexCompression::HalfToFloat(static_cast<uint16_t>(half))), half) << std::hex << half;
+	}
+}
+
+TEST(VertexCompression, FloatToHalfRoundsToNearestEven)
+{
+	EXPECT_EQ(VertexCompression::FloatToHalf(1.0f), 0x3c00);
+	EXPECT_EQ(VertexCompression::FloatToHalf(-2.0f), 0xc000);
+	EXPECT_EQ(VertexCompression::FloatToHalf(65504.0f), 0x7bff);
+	EXPECT_EQ(VertexCompression::FloatToHalf(1e6f), 0x7c00);
+	EXPECT_EQ(VertexCompression::FloatToHalf(-1e6f), 0xfc00);
+	EXPECT_EQ(VertexCompression::FloatToHalf(1e-10f), 0x0000);
+
+	// Halfway between 1 and the next half rounds down to the even mantissa, halfway above that rounds up
+	EXPECT_EQ(VertexCompression::FloatToHalf(AsFloat(0x3f801000u)), 0x3c00);
+	EXPECT_EQ(VertexCompression::FloatToHalf(AsFloat(0x3f803000u)), 0x3c02);
+	EXPECT_EQ(VertexCompression::FloatToHalf(AsFloat(0x3f801001u)), 0x3c01);
+
+	// Smallest subnormal half
+	EXPECT_EQ(VertexCompression::FloatToHalf(std::ldexp(1.0f, -24)), 0x0001);
+	EXPECT_FLOAT_EQ(VertexCompression::HalfToFloat(0x0001), std::ldexp(1.0f, -24));
+}
+
+TEST(VertexCompression, PackedVerticesRoundTripWithinQuantizationError)
+{
+	const std::vector<Vertex> vertices = MakeVertices();
+	const VertexBounds bounds = VertexCompression::ComputeBounds(vertices.data(), vertices.size());
+
+	std::vector<PackedVertex> packed(vertices.size());
+	std::vector<Vertex> decoded(vertices.size());
+	VertexCompression::EncodeVertices(vertices.data(), vertices.size(), bounds, packed.data());
+	VertexCompression::DecodeVertices(packed.data(), packed.size(), bounds, decoded.data());
+
+	// Half a snorm16 step of the extent on each axis, plus float rounding
+	const float tolerance[3] = { bounds.extent.x / 32767.0f, bounds.extent.y / 32767.0f, bounds.extent.z / 32767.0f };
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		EXPECT_NEAR(decoded[i].pos.x, vertices[i].pos.x, tolerance[0]) << "vertex " << i;
+		EXPECT_NEAR(decoded[i].pos.y, vertices[i].pos.y, tolerance[1]) << "vertex " << i;
+		EXPECT_NEAR(decoded[i].pos.z, vertices[i].pos.z, tolerance[2]) << "vertex " << i;
+		EXPECT_EQ(packed[i].pos[3], 0);
+
+		EXPECT_NEAR(decoded[i].color.x, vertices[i].color.x, ColorTolerance) << "vertex " << i;
+		EXPECT_NEAR(decoded[i].color.y, vertices[i].color.y, ColorTolerance) << "vertex " << i;
+		EXPECT_NEAR(decoded[i].color.z, vertices[i].color.z, ColorTolerance) << "vertex " << i;
+		EXPECT_EQ(decoded[i].color.w, vertices[i].color.w) << "vertex " << i;
+	}
+
+	// The bounds corners use the full snorm16 range
+	EXPECT_EQ(packed.front().pos[0], -32767);
+	EXPECT_EQ(packed.back().pos[0], 32767);
+}
+
+TEST(VertexCompression, HalfVerticesRoundTripWithinHalfPrecision)
+{
+	const std::vector<Vertex> vertices = MakeVertices();
+
+	std::vector<PackedVertexHalf> packed(vertices.size());
+	std::vector<Vertex> decoded(vertices.size());
+	VertexCompression::EncodeVertices(vertices.data(), vertices.size(), packed.data());
+	VertexCompression::DecodeVertices(packed.data(), packed.size(), decoded.data());
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		// 11 significant bits, so the relative error is at most 2^-11
+		EXPECT_NEAR(decoded[i].pos.x, vertices[i].pos.x, std::abs(vertices[i].pos.x) * 0x1p-11f) << "vertex " << i;
+		EXPECT_NEAR(decoded[i].pos.y, vertices[i].pos.y, std::abs(vertices[i].pos.y) * 0x1p-11f) << "vertex " << i;
+		EXPECT_NEAR(decoded[i].pos.z, vertices[i].pos.z, std::abs(vertices[i].pos.z) * 0x1p-11f) << "vertex " << i;
+		EXPECT_NEAR(decoded[i].color.x, vertices[i].color.x, ColorTolerance) << "vertex " << i;
+	}
+}
+
+TEST(VertexCompression, FlatMeshBoundsStayDecodable)
+{
+	const Vertex vertices[2] = {
+		Vertex{ Math::Float3{ -1.0f, 2.0f, 5.0f }, Math::Float4{ 0.0f, 0.0f, 0.0f, 1.0f } },
+		Vertex{ Math::Float3{ 3.0f, 2.0f, 5.0f }, Math::Float4{ 1.0f, 1.0f, 1.0f, 1.0f } }
+	};
+	const VertexBounds bounds = VertexCompression::ComputeBounds(vertices, 2);
+	EXPECT_GT(bounds.extent.y, 0.0f);
+	EXPECT_GT(bounds.extent.z, 0.0f);
+
+	PackedVertex packed[2];
+	Vertex decoded[2];
+	VertexCompression::EncodeVertices(vertices, 2, bounds, packed);
+	VertexCompression::DecodeVertices(packed, 2, bounds, decoded);
+	for (size_t i = 0; i < 2; i++)
+	{
+		EXPECT_NEAR(decoded[i].pos.x, vertices[i].pos.x, 1e-4f);
+		EXPECT_FLOAT_EQ(decoded[i].pos.y, vertices[i].pos.y);
+		EXPECT_FLOAT_EQ(decoded[i].pos.z, vertices[i].pos.z);
+	}
+}
+
+TEST(VertexCompression, OctahedralNormalsRoundTrip)
+{
+	std::vector<Math::Float3> normals;
+	for (int i = 0; i < 64; i++)
+	{
+		for (int j = 0; j <= 32; j++)
+		{
+			const float phi = static_cast<float>(i) * 6.2831853f / 64.0f;
+			const float theta = static_cast<float>(j) * 3.1415927f / 32.0f;
+			normals.push_back(Math::Float3{ std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) });
+		}
+	}
+
+	std::vector<uint32_t> encoded(normals.size());
+	std::vector<Math::Float3> decoded(normals.size());
+	VertexCompression::EncodeNormals(normals.data(), normals.size(), encoded.data());
+	VertexCompression::DecodeNormals(encoded.data(), encoded.size(), decoded.data());
+
+	for (size_t i = 0; i < normals.size(); i++)
+	{
+		const float dot = normals[i].x * decoded[i].x + normals[i].y * decoded[i].y + normals[i].z * decoded[i].z;
+		EXPECT_GT(dot, 0.99999f) << "normal " << i;
+	}
+}
+
+TEST(VertexLayout, PackedLayoutCarriesPositionBounds)
+{
+	constexpr VertexBounds bounds{ { 1.0f, 2.0f, 3.0f }, { 4.0f, 5.0f, 6.0f } };
+	constexpr VertexLayout layout = VertexLayout::Packed(bounds);
+	static_assert(layout.GetStride() == sizeof(PackedVertex));
+	static_assert(layout.GetAttributeCount() == 2);
+
+	EXPECT_EQ(layout.GetPositionBounds().center.y, 2.0f);
+	EXPECT_EQ(layout.GetPositionBounds().extent.z, 6.0f);
+	EXPECT_EQ(VertexLayout::Standard().GetPositionBounds().extent.x, 1.0f);
+}
+
+TEST(VertexLayout, AddPastMaxAttributesThrows)
+{
+	VertexLayout layout;
+	for (size_t i = 0; i < VertexLayout::MaxAttributes; i++)
+		layout.Add(VertexSemantic::TexCoord, VertexFormat::Half2, static_cast<uint8_t>(i));
+
+	EXPECT_THROW(layout.Add(VertexSemantic::TexCoord, VertexFormat::Half2, VertexLayout::MaxAttributes), std::out_of_range);
+	EXPECT_EQ(layout.GetAttributeCount(), VertexLayout::MaxAttributes);
+	EXPECT_EQ(layout.GetStride(), VertexLayout::MaxAttributes * VertexFormatSize(VertexFormat::Half2));
+}
@@ -0,0 +1,222 @@
+#ifndef ULTREALITY_RENDERING_ADAPTER_TOPOLOGY_H
+#define ULTREALITY_RENDERING_ADAPTER_TOPOLOGY_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <MultiAdapterScheduler.h>
+
+#include <IRenderer.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Adapters, by AdapterDesc::localID, whose description or outputs changed in a <see cref="AdapterTopology::Refresh"/>
+	/// </summary>
+	struct AdapterTopologyChange
+	{
+		std::vector<uint32_t> added;
+		std::vector<uint32_t> removed;
+		std::vector<uint32_t> modified; // Description, outputs or display modes changed
+	};
+
+	/// <summary>
+	/// Cache of the adapters, their outputs and the outputs' display modes. The renderer's hardware queries enumerate the devices and
+	/// allocate on every call, the cache is only rebuilt by <see cref="Refresh"/> (at startup and when the platform reports a device change)
+	/// and notifies its listeners of what changed
+	/// </summary>
+	class AdapterTopology
+	{
+	public:
+		using Listener = std::function<void(const AdapterTopology&, const AdapterTopologyChange&)>;
+
+	protected:
+		std::vector<AdapterDesc> m_adapters;
+		std::vector<std::vector<OutputDesc>> m_outputs;				// Parallel to m_adapters
+		std::vector<std::vector<std::vector<DisplayMode>>> m_modes;	// Parallel to m_outputs
+		std::vector<std::pair<uint32_t, Listener>> m_listeners;
+		uint32_t m_nextListener = 0;
+
+		static bool Equal(const AdapterDesc& a, const AdapterDesc& b) noexcept
+		{
+			return a.name == b.name && a.vendorID == b.vendorID && a.deviceID == b.deviceID && a.subSysID == b.subSysID
+				&& a.revision == b.revision && a.videoMemory == b.videoMemory && a.sharedMemory == b.sharedMemory;
+		}
+
+		static bool Equal(const OutputDesc& a, const OutputDesc& b) noexcept
+		{
+			return a.name == b.name && a.width == b.width && a.height == b.height && a.localID == b.localID;
+		}
+
+		static bool Equal(const DisplayMode& a, const DisplayMode& b) noexcept
+		{
+			return a.width == b.width && a.height == b.height
+				&& a.refreshRate.numerator == b.refreshRate.numerator && a.refreshRate.denominator == b.refreshRate.denominator;
+		}
+
+		template<typename T>
+		static bool Equal(const std::vector<T>& a, const std::vector<T>& b) noexcept
+		{
+			return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const T& x, const T& y) { return Equal(x, y); });
+		}
+
+		size_t IndexOf(uint32_t adapterLocalID) const
+		{
+			for (size_t a = 0; a < m_adapters.size(); a++)
+			{
+				if (m_adapters[a].localID == adapterLocalID)
+					return a;
+			}
+
+			throw std::out_of_range("No adapter with the requested local id");
+		}
+
+	public:
+		/// <summary>
+		/// Re-enumerate the renderer's adapters, outputs and display modes and notify the listeners if anything changed
+		/// </summary>
+		/// <param name="renderer">Renderer to query</param>
+		/// <returns>True if the topology changed</returns>
+		bool Refresh(const IRenderer& renderer)
+		{
+			std::vector<AdapterDesc> adapters = renderer.GetDisplayAdapters();
+			std::vector<std::vector<OutputDesc>> outputs(adapters.size());
+			std::vector<std::vector<std::vector<DisplayMode>>> modes(adapters.size());
+			for (size_t a = 0; a < adapters.size(); a++)
+			{
+				outputs[a] = renderer.GetOutputsForAdapter(adapters[a]);
+				for (const OutputDesc& output : outputs[a])
+					modes[a].push_back(renderer.GetDisplayModesForOutput(output));
+			}
+
+			AdapterTopologyChange change;
+			for (size_t a = 0; a < adapters.size(); a++)
+			{
+				const auto previous = std::find_if(m_adapters.begin(), m_adapters.end(), [&](const AdapterDesc& p) { return p.localID == adapters[a].localID; });
+				if (previous == m_adapters.end())
+				{
+					change.added.push_back(adapters[a].localID);
+					continue;
+				}
+
+				const size_t p = static_cast<size_t>(previous - m_adapters.begin());
+				bool same = Equal(adapters[a], *previous) && Equal(outputs[a], m_outputs[p]) && modes[a].size() == m_modes[p].size();
+				for (size_t o = 0; same && o < modes[a].size(); o++)
+					same = Equal(modes[a][o], m_modes[p][o]);
+				if (!same)
+					change.modified.push_back(adapters[a].localID);
+			}
+			for (const AdapterDesc& previous : m_adapters)
+			{
+				if (std::none_of(adapters.begin(), adapters.end(), [&](const AdapterDesc& a) { return a.localID == previous.localID; }))
+					change.removed.push_back(previous.localID);
+			}
+
+			m_adapters = std::move(adapters);
+			m_outputs = std::move(outputs);
+			m_modes = std::move(modes);
+
+			if (change.added.empty() && change.removed.empty() && change.modified.empty())
+				return false;
+
+			for (const auto& [id, listener] : m_listeners)
+				listener(*this, change);
+
+			return true;
+		}
+
+		/// <summary>
+		/// Register a callable invoked after every <see cref="Refresh"/> that changed the topology
+		/// </summary>
+		/// <returns>Token for <see cref="Unsubscribe"/></returns>
+		uint32_t Subscribe(Listener listener)
+		{
+			m_listeners.emplace_back(m_nextListener, std::move(listener));
+			return m_nextListener++;
+		}
+
+		/// <summary>
+		/// Remove a listener registered with <see cref="Subscribe"/>
+		/// </summary>
+		void Unsubscribe(uint32_t token) noexcept
+		{
+			m_listeners.erase(std::remove_if(m_listeners.begin(), m_listeners.end(), [token](const auto& entry) { return entry.first == token; }), m_listeners.end());
+		}
+
+		/// <summary>
+		/// Get the cached adapter descriptions
+		/// </summary>
+		const std::vector<AdapterDesc>& GetAdapters() const noexcept
+		{
+			return m_adapters;
+		}
+
+		/// <summary>
+		/// Get the cached outputs of an adapter
+		/// </summary>
+		/// <param name="adapterLocalID">AdapterDesc::localID of the adapter</param>
+		/// <exception cref="std.out_of_range">Thrown if no cached adapter has the id</exception>
+		const std::vector<OutputDesc>& GetOutputs(uint32_t adapterLocalID) const
+		{
+			return m_outputs[IndexOf(adapterLocalID)];
+		}
+
+		/// <summary>
+		/// Get the cached display modes of an adapter's output
+		/// </summary>
+		/// <param name="adapterLocalID">AdapterDesc::localID of the adapter</param>
+		/// <param name="outputLocalID">OutputDesc::localID of the output</param>
+		/// <exception cref="std.out_of_range">Thrown if no cached adapter or output has the id</exception>
+		const std::vector<DisplayMode>& GetDisplayModes(uint32_t adapterLocalID, uint32_t outputLocalID) const
+		{
+			const size_t a = IndexOf(adapterLocalID);
+			for (size_t o = 0; o < m_outputs[a].size(); o++)
+			{
+				if (m_outputs[a][o].localID == outputLocalID)
+					return m_modes[a][o];
+			}
+
+			throw std::out_of_range("No output with the requested local id on the adapter");
+		}
+	};
+
+	/// <summary>
+	/// Configure a multi-adapter scheduler with the hardware adapters of a topology. Adapters without dedicated video memory (software rasterizers)
+	/// are skipped unless there is no other adapter, and the first adapter with an output presents
+	/// </summary>
+	/// <exception cref="std.invalid_argument">Thrown if the topology has no adapters</exception>
+	inline void ConfigureMultiAdapter(MultiAdapterScheduler& scheduler, const AdapterTopology& topology, MultiAdapterMode mode, uint16_t width, uint16_t height)
+	{
+		std::vector<uint32_t> adapterIDs;
+		for (const AdapterDesc& adapter : topology.GetAdapters())
+		{
+			if (adapter.videoMemory > 0)
+				adapterIDs.push_back(adapter.localID);
+		}
+		if (adapterIDs.empty())
+		{
+			for (const AdapterDesc& adapter : topology.GetAdapters())
+				adapterIDs.push_back(adapter.localID);
+		}
+		if (adapterIDs.empty())
+			throw std::invalid_argument("Adapter topology has no adapters");
+
+		uint32_t presenterID = adapterIDs.front();
+		for (uint32_t id : adapterIDs)
+		{
+			if (!topology.GetOutputs(id).empty())
+			{
+				presenterID = id;
+				break;
+			}
+		}
+
+		scheduler.Configure(mode, adapterIDs, presenterID, width, height);
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_ADAPTER_TOPOLOGY_H
@@ -0,0 +1,451 @@
+#ifndef ULTREALITY_RENDERING_CAPTURE_REPLAYER_H
+#define ULTREALITY_RENDERING_CAPTURE_REPLAYER_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <unordered_map>
+
+#include <IRenderer.h>
+#include <RenderCapture.h>
+
+namespace UltReality::Rendering
+{
+	struct ReplayCallStats
+	{
+		uint64_t count = 0;
+		double totalMs = 0.0;
+		double maxMs = 0.0;
+	};
+
+	struct ReplayFrameStats
+	{
+		double cpuMs;										// Time spent in renderer calls since the previous Present, including this Present
+		float gpuMs;										// GetGpuFrameTime after Present, 0 without GPU profiling
+		std::array<double, GpuTimingPassCount> cpuPassMs;	// Time spent in renderer calls from BeginGpuTimer to EndGpuTimer of each pass, both included
+		std::array<float, GpuTimingPassCount> gpuPassMs;	// GetGpuTimeForPass after Present, 0 without GPU profiling
+	};
+
+	struct ReplayReport
+	{
+		std::array<ReplayCallStats, static_cast<size_t>(CaptureCall::Count)> calls{};
+		std::vector<ReplayFrameStats> frames;	// One per Present
+		double totalMs = 0.0;					// Time spent in renderer calls, excluding decoding the capture
+		uint64_t readBackMismatches = 0;		// ReadBuffer calls that returned different bytes than when recorded, only counted when verifying
+	};
+
+	/// <summary>
+	/// Re-drives a renderer with a capture written by <see cref="RecordingRenderer"/> as fast as it accepts the calls, and times every call,
+	/// pass and frame. Resource handles are remapped from the recorded values to the ones the replayed renderer returns
+	/// </summary>
+	class CaptureReplayer
+	{
+	protected:
+		CaptureReader m_reader;
+		std::unordered_map<BufferHandle, BufferHandle> m_buffers;
+		std::unordered_map<TextureHandle, TextureHandle> m_textures;
+		std::unordered_map<ShaderHandle, ShaderHandle> m_shaders;
+		std::unordered_map<BufferHandle, void*> m_mappings;
+		std::vector<uint8_t> m_readback;
+
+		template<typename Handle>
+		static Handle Remap(const std::unordered_map<Handle, Handle>& handles, Handle recorded)
+		{
+			const auto handle = handles.find(recorded);
+			if (handle == handles.end())
+				throw std::runtime_error("Capture references a resource that was not created in the capture");
+
+			return handle->second;
+		}
+
+		template<typename Settings>
+		static Settings ReadSettings(PayloadReader& payload)
+		{
+			return payload.Read<Settings>();
+		}
+
+		static void ApplySettings(IRenderer& renderer, CaptureCall call, PayloadReader& payload)
+		{
+			const bool init = call == CaptureCall::InitSettings;
+			switch (payload.Read<CaptureSettings>())
+			{
+			case CaptureSettings::Display:
+			{
+				const DisplaySettings settings = ReadSettings<DisplaySettings>(payload);
+				init ? renderer.InitDisplaySettings(settings) : renderer.SetDisplaySettings(settings);
+				break;
+			}
+			case CaptureSettings::AntiAliasing:
+			{
+				const AntiAliasingSettings settings = ReadSettings<AntiAliasingSettings>(payload);
+				init ? renderer.InitAntiAliasingSettings(settings) : renderer.SetAntiAliasingSettings(settings);
+				break;
+			}
+			case CaptureSettings::Texture:
+			{
+				const TextureSettings settings = ReadSettings<TextureSettings>(payload);
+				init ? renderer.InitTextureSettings(settings) : renderer.SetTextureSettings(settings);
+				break;
+			}
+			case CaptureSettings::Shadow:
+			{
+				const ShadowSettings settings = ReadSettings<ShadowSettings>(payload);
+				init ? renderer.InitShadowSettings(settings) : renderer.SetShadowSettings(settings);
+				break;
+			}
+			case CaptureSettings::Lighting:
+			{
+				const LightingSettings settings = ReadSettings<LightingSettings>(payload);
+				init ? renderer.InitLightingSettings(settings) : renderer.SetLightingSettings(settings);
+				break;
+			}
+			case CaptureSettings::PostProcessing:
+			{
+				const PostProcessingSettings settings = ReadSettings<PostProcessingSettings>(payload);
+				init ? renderer.InitPostProcessingSettings(settings) : renderer.SetPostProcessingSettings(settings);
+				break;
+			}
+			case CaptureSettings::Performance:
+			{
+				const PerformanceSettings settings = ReadSettings<PerformanceSettings>(payload);
+				init ? renderer.InitPerformanceSettings(settings) : renderer.SetPerformanceSettings(settings);
+				break;
+			}
+			default:
+				throw std::runtime_error("Capture settings record has an unknown settings type");
+			}
+		}
+
+	public:
+		/// <summary>
+		/// Load a capture
+		/// </summary>
+		/// <exception cref="std.runtime_error">Thrown if the file can not be read or is not a capture of this version</exception>
+		explicit CaptureReplayer(const std::filesystem::path& path) : m_reader(path)
+		{}
+
+		/// <summary>
+		/// Replay the whole capture. Shader files referenced by the capture must exist at their recorded paths
+		/// </summary>
+		/// <param name="renderer">Renderer to drive. Should be freshly created, the capture begins with its settings and Initialize</param>
+		/// <param name="viewport">Window the replay renders to, used in place of the recorded one</param>
+		/// <param name="verifyReadBack">Compare the bytes every ReadBuffer returns with the recorded ones and count the differences in the report</param>
+		/// <returns>Timings of the replay</returns>
+		/// <exception cref="std.runtime_error">Thrown if the capture is malformed</exception>
+		ReplayReport Replay(IRenderer& renderer, DisplayTarget viewport, bool verifyReadBack = false)
+		{
+			using Clock = std::chrono::steady_clock;
+
+			m_reader.Rewind();
+			m_buffers.clear();
+			m_textures.clear();
+			m_shaders.clear();
+			m_mappings.clear();
+
+			ReplayReport report;
+			ReplayFrameStats frame{};
+			std::array<bool, GpuTimingPassCount> passOpen{};
+
+			CaptureRecord record;
+			while (m_reader.Next(record))
+			{
+				PayloadReader payload(record.payload, static_cast<size_t>(record.size));
+				Clock::time_point start;
+				Clock::time_point end;
+				size_t closedPass = GpuTimingPassCount;
+
+				// Decode first, then time only the renderer call
+				const auto timed = [&](auto&& call)
+				{
+					start = Clock::now();
+					call();
+					end = Clock::now();
+				};
+
+				switch (record.call)
+				{
+				case CaptureCall::Initialize:
+					timed([&] { renderer.Initialize(viewport); });
+					break;
+				case CaptureCall::InitSettings:
+				case CaptureCall::SetSettings:
+					timed([&] { ApplySettings(renderer, record.call, payload); });
+					break;
+				case CaptureCall::CreateBuffer:
+				{
+					const BufferHandle recorded = payload.Read<BufferHandle>();
+					const BufferUsage usage = payload.Read<BufferUsage>();
+					const BufferType type = payload.Read<BufferType>();
+					const BufferMemoryType memType = payload.Read<BufferMemoryType>();
+					const size_t size = payload.ReadSize();
+					const uint8_t* data = payload.Read<uint8_t>() ? payload.ReadBytes(size) : nullptr;
+					timed([&] { m_buffers[recorded] = renderer.CreateBuffer(data, size, usage, type, memType); });
+					break;
+				}
+				case CaptureCall::CreateVertexBuffer:
+				{
+					const BufferHandle recorded = payload.Read<BufferHandle>();
+					const BufferUsage usage = payload.Read<BufferUsage>();
+					const BufferMemoryType memType = payload.Read<BufferMemoryType>();
+					VertexLayout layout;
+					const uint8_t attributeCount = payload.Read<uint8_t>();
+					if (attributeCount > VertexLayout::MaxAttributes)
+						throw std::runtime_error("Capture vertex layout has more than VertexLayout::MaxAttributes attributes");
+					for (uint8_t i = 0; i < attributeCount; i++)
+					{
+						const VertexSemantic semantic = payload.Read<VertexSemantic>();
+						const uint8_t semanticIndex = payload.Read<uint8_t>();
+						layout.Add(semantic, payload.Read<VertexFormat>(), semanticIndex);
+					}
+					layout.SetPositionBounds(payload.Read<VertexBounds>());
+					const size_t size = payload.ReadSize();
+					const uint8_t* data = payload.Read<uint8_t>() ? payload.ReadBytes(size) : nullptr;
+					timed([&] { m_buffers[recorded] = renderer.CreateVertexBuffer(data, size, layout, usage, memType); });
+					break;
+				}
+				case CaptureCall::UpdateBuffer:
+				{
+					const BufferHandle handle = Remap(m_buffers, payload.Read<BufferHandle>());
+					const size_t offset = payload.ReadSize();
+					const size_t size = payload.ReadSize();
+					const uint8_t* data = payload.ReadBytes(size);
+					timed([&] { renderer.UpdateBuffer(handle, data, size, offset); });
+					break;
+				}
+				case CaptureCall::DestroyBuffer:
+				{
+					const BufferHandle recorded = payload.Read<BufferHandle>();
+					const BufferHandle handle = Remap(m_buffers, recorded);
+					timed([&] { renderer.DestroyBuffer(handle); });
+					m_buffers.erase(recorded);
+					break;
+				}
+				case CaptureCall::MapBuffer:
+				{
+					const BufferHandle handle = Remap(m_buffers, payload.Read<BufferHandle>());
+					const size_t size = payload.ReadSize();
+					const size_t offset = payload.ReadSize();
+					const MapType mapType = payload.Read<MapType>();
+					timed([&] { m_mappings[handle] = renderer.MapBuffer(handle, size, offset, mapType); });
+					break;
+				}
+				case CaptureCall::UnmapBuffer:
+				{
+					const BufferHandle handle = Remap(m_buffers, payload.Read<BufferHandle>());
+					const size_t size = payload.ReadSize();
+					const uint8_t* data = payload.ReadBytes(size);
+					void* mapped = m_mappings[handle];
+					timed([&]
+					{
+						if (size && mapped)
+							std::memcpy(mapped, data, size);
+						renderer.UnmapBuffer(handle);
+					});
+					m_mappings.erase(handle);
+					break;
+				}
+				case CaptureCall::ReadBuffer:
+				{
+					const BufferHandle handle = Remap(m_buffers, payload.Read<BufferHandle>());
+					const size_t size = payload.ReadSize();
+					const size_t offset = payload.ReadSize();
+					const uint8_t* recorded = payload.ReadBytes(size);
+					m_readback.resize(std::max(m_readback.size(), size));
+					timed([&] { renderer.ReadBuffer(handle, m_readback.data(), size, offset); });
+					if (verifyReadBack && size && std::memcmp(m_readback.data(), recorded, size) != 0)
+						report.readBackMismatches++;
+					break;
+				}
+				case CaptureCall::CreateTexture:
+				{
+					const TextureHandle recorded = payload.Read<TextureHandle>();
+					const TextureDesc desc = payload.Read<TextureDesc>();
+					const size_t size = payload.ReadSize();
+					const uint8_t* data = size ? payload.ReadBytes(size) : nullptr;
+					timed([&] { m_textures[recorded] = renderer.CreateTexture(desc, data); });
+					break;
+				}
+				case CaptureCall::UpdateTexture:
+				{
+					const TextureHandle handle = Remap(m_textures, payload.Read<TextureHandle>());
+					const TextureUpdateDesc region = payload.Read<TextureUpdateDesc>();
+					const size_t size = payload.ReadSize();
+					const uint8_t* data = payload.ReadBytes(size);
+					timed([&] { renderer.UpdateTexture(handle, data, size, region); });
+					break;
+				}
+				case CaptureCall::DestroyTexture:
+				{
+					const TextureHandle recorded = payload.Read<TextureHandle>();
+					const TextureHandle handle = Remap(m_textures, recorded);
+					timed([&] { renderer.DestroyTexture(handle); });
+					m_textures.erase(recorded);
+					break;
+				}
+				case CaptureCall::CreateShaderFromSource:
+				case CaptureCall::CreateShaderFromFile:
+				case CaptureCall::CreateShaderFromBinary:
+				{
+					const ShaderHandle recorded = payload.Read<ShaderHandle>();
+					const ShaderType type = payload.Read<ShaderType>();
+					const std::string source = payload.ReadString();
+					if (record.call == CaptureCall::CreateShaderFromSource)
+						timed([&] { m_shaders[recorded] = renderer.CreateShaderFromSource(source, type); });
+					else if (record.call == CaptureCall::CreateShaderFromFile)
+					{
+						const std::filesystem::path path(source);
+						timed([&] { m_shaders[recorded] = renderer.CreateShaderFromSource(path, type); });
+					}
+					else
+						timed([&] { m_shaders[recorded] = renderer.CreateShaderFromBinary(source, type); });
+					break;
+				}
+				case CaptureCall::DestroyShader:
+				{
+					const ShaderHandle recorded = payload.Read<ShaderHandle>();
+					const ShaderHandle handle = Remap(m_shaders, recorded);
+					timed([&] { renderer.DestroyShader(handle); });
+					m_shaders.erase(recorded);
+					break;
+				}
+				case CaptureCall::Render:
+					timed([&] { renderer.Render(); });
+					break;
+				case CaptureCall::Present:
+					timed([&] { renderer.Present(); });
+					break;
+				case CaptureCall::FlushCommandQueue:
+					timed([&] { renderer.FlushCommandQueue(); });
+					break;
+				case CaptureCall::EnableGPUProfiling:
+				{
+					const bool enable = payload.Read<uint8_t>() != 0;
+					timed([&] { renderer.EnableGPUProfiling(enable); });
+					break;
+				}
+				case CaptureCall::BeginGpuTimer:
+				case CaptureCall::EndGpuTimer:
+				{
+					const GpuTimingPass pass = payload.Read<GpuTimingPass>();
+					const size_t index = static_cast<size_t>(pass);
+					if (index >= GpuTimingPassCount)
+						throw std::runtime_error("Capture timer record has an unknown pass");
+
+					if (record.call == CaptureCall::BeginGpuTimer)
+					{
+						timed([&] { renderer.BeginGpuTimer(pass); });
+						passOpen[index] = true;
+					}
+					else
+					{
+						timed([&] { renderer.EndGpuTimer(pass); });
+						closedPass = index;
+					}
+					break;
+				}
+				case CaptureCall::ResetGpuTimers:
+					timed([&] { renderer.ResetGpuTimers(); });
+					break;
+				default:
+					throw std::runtime_error("Capture record has an unknown call");
+				}
+
+				const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+				ReplayCallStats& stats = report.calls[static_cast<size_t>(record.call)];
+				stats.count++;
+				stats.totalMs += ms;
+				stats.maxMs = std::max(stats.maxMs, ms);
+				report.totalMs += ms;
+				frame.cpuMs += ms;
+
+				// Open passes only accumulate the timed calls, not the decoding between them
+				for (size_t pass = 0; pass < GpuTimingPassCount; pass++)
+				{
+					if (passOpen[pass])
+						frame.cpuPassMs[pass] += ms;
+				}
+				if (closedPass < GpuTimingPassCount)
+					passOpen[closedPass] = false;
+
+				if (record.call == CaptureCall::Present)
+				{
+					if (renderer.IsGpuProfilingEnabled())
+					{
+						frame.gpuMs = renderer.GetGpuFrameTime();
+						for (size_t pass = 0; pass < GpuTimingPassCount; pass++)
+							frame.gpuPassMs[pass] = renderer.GetGpuTimeForPass(static_cast<GpuTimingPass>(pass));
+					}
+
+					report.frames.push_back(frame);
+					frame = ReplayFrameStats{};
+				}
+			}
+
+			return report;
+		}
+	};
+
+	/// <summary>
+	/// Write a replay report as text: per-call totals, the per-pass averages and the frame time distribution
+	/// </summary>
+	inline void WriteReplayReport(const ReplayReport& report, std::ostream& stream)
+	{
+		stream << std::fixed << std::setprecision(3);
+		stream << "Total " << report.totalMs << " ms over " << report.frames.size() << " frames\n";
+		if (report.readBackMismatches)
+			stream << "ReadBuffer mismatches " << report.readBackMismatches << '\n';
+		stream << '\n';
+
+		stream << std::left << std::setw(26) << "Call" << std::right << std::setw(10) << "Count" << std::setw(14) << "Total ms" << std::setw(12) << "Mean ms" << std::setw(12) << "Max ms" << '\n';
+		for (size_t call = 0; call < report.calls.size(); call++)
+		{
+			const ReplayCallStats& stats = report.calls[call];
+			if (stats.count == 0)
+				continue;
+
+			stream << std::left << std::setw(26) << CaptureCallName(static_cast<CaptureCall>(call)) << std::right << std::setw(10) << stats.count
+				<< std::setw(14) << stats.totalMs << std::setw(12) << stats.totalMs / stats.count << std::setw(12) << stats.maxMs << '\n';
+		}
+
+		if (report.frames.empty())
+			return;
+
+		std::vector<double> cpu;
+		std::array<double, GpuTimingPassCount> cpuPass{};
+		std::array<double, GpuTimingPassCount> gpuPass{};
+		double gpu = 0.0;
+		for (const ReplayFrameStats& frame : report.frames)
+		{
+			cpu.push_back(frame.cpuMs);
+			gpu += frame.gpuMs;
+			for (size_t pass = 0; pass < GpuTimingPassCount; pass++)
+			{
+				cpuPass[pass] += frame.cpuPassMs[pass];
+				gpuPass[pass] += frame.gpuPassMs[pass];
+			}
+		}
+		std::sort(cpu.begin(), cpu.end());
+
+		static constexpr const char* passNames[GpuTimingPassCount] = {
+			"Frame", "ShadowPass", "GeometryPass", "LightingPass", "PostProcessing", "ComputePass", "UI", "Custom0", "Custom1", "Custom2"
+		};
+		const double frameCount = static_cast<double>(report.frames.size());
+
+		stream << "\nFrame CPU ms  min " << cpu.front() << "  median " << cpu[cpu.size() / 2] << "  p99 " << cpu[std::min(cpu.size() - 1, cpu.size() * 99 / 100)]
+			<< "  max " << cpu.back() << "\nFrame GPU ms  mean " << gpu / frameCount << "\n\n";
+
+		stream << std::left << std::setw(26) << "Pass" << std::right << std::setw(14) << "CPU mean ms" << std::setw(14) << "GPU mean ms" << '\n';
+		for (size_t pass = 0; pass < GpuTimingPassCount; pass++)
+		{
+			if (cpuPass[pass] == 0.0 && gpuPass[pass] == 0.0)
+				continue;
+
+			stream << std::left << std::setw(26) << passNames[pass] << std::right << std::setw(14) << cpuPass[pass] / frameCount << std::setw(14) << gpuPass[pass] / frameCount << '\n';
+		}
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_CAPTURE_REPLAYER_H
@@ -9,10 +9,17 @@
 #include <DisplayTarget.h>
 #include <PlatformMessageHandler.h>
 
+#include <VertexLayout.h>
+
 #include <IRenderer_ResourceCreation.h>
 #include <IRenderer_HardwareQuery.h>
 #include <IRenderer_Settings.h>
+#include <IRenderer_SettingsDiff.h>
 #include <IRenderer_Profiling.h>
+#include <IRenderer_LOD.h>
+#include <IRenderer_Shadows.h>
+#include <IRenderer_Temporal.h>
+#include <IRenderer_PostProcessing.h>
 
 #if defined(_WIN_TARGET)
 	#if defined(RENDERER_INTERFACE_EXPORTS)
@@ -74,6 +81,23 @@ namespace UltReality::Rendering
 		/// <param name="type">Specify the type of buffer to create. Vertex, Index, Constant, Structured, UnorderedAccess</param>
 		/// <returns>A handle to the created GPU buffer</returns>
 		virtual BufferHandle RENDERER_INTERFACE_CALL CreateBuffer(const void* data, size_t size, BufferUsage usage, BufferType type, BufferMemoryType memType) = 0;
+
+		/// <summary>
+		/// Create a GPU vertex buffer resource along with the description of how its vertices are laid out. 
+		/// Renderers that build input layouts from the buffer override this, the default creates a plain vertex buffer
+		/// </summary>
+		/// <param name="data">Vertex data to load into buffer at creation</param>
+		/// <param name="size">Number of bytes in the data</param>
+		/// <param name="layout">Description of the attributes of a single vertex, see <seealso cref="UltReality.Rendering.VertexLayout"/>. 
+		/// Normalized positions are decoded against the layout's position bounds</param>
+		/// <param name="usage">Specify if the buffer is static or dynamic</param>
+		/// <param name="memType">Specify the memory heap the buffer is created in</param>
+		/// <returns>A handle to the created GPU buffer</returns>
+		virtual BufferHandle RENDERER_INTERFACE_CALL CreateVertexBuffer(const void* data, size_t size, const VertexLayout& layout, BufferUsage usage, BufferMemoryType memType)
+		{
+			(void)layout;
+			return CreateBuffer(data, size, usage, BufferType::Vertex, memType);
+		}
 		
 		/// <summary>
 		/// Update a GPU buffer resource
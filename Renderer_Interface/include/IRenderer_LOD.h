@@ -0,0 +1,69 @@
+#ifndef ULTREALITY_RENDERING_IRENDERER_LOD_H
+#define ULTREALITY_RENDERING_IRENDERER_LOD_H
+
+#include <LODSelector.h>
+
+#include <IRenderer_Settings.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Derive the level of detail selection for the main view from the texture quality tier, so geometry and texture detail scale together
+	/// </summary>
+	/// <param name="settings">The renderer's texture settings</param>
+	/// <returns>Selection settings with the bias and most detailed level of the tier</returns>
+	inline LODSelectionSettings MakeLODSelectionSettings(const TextureSettings& settings) noexcept
+	{
+		LODSelectionSettings selection;
+		switch (settings.quality)
+		{
+		case TextureSettings::TextureQuality::low:
+			selection.bias = 0.5f;
+			selection.minLevel = 1;
+			break;
+		case TextureSettings::TextureQuality::medium:
+			selection.bias = 0.75f;
+			break;
+		case TextureSettings::TextureQuality::high:
+			selection.bias = 1.0f;
+			break;
+		case TextureSettings::TextureQuality::ultra:
+			selection.bias = 1.5f;
+			break;
+		}
+
+		return selection;
+	}
+
+	/// <summary>
+	/// Derive the level of detail selection for shadow casters from the shadow quality tier.
+	/// Shadow maps resolve less detail than the main view, so casters switch to coarser levels sooner
+	/// </summary>
+	/// <param name="settings">The renderer's shadow settings</param>
+	/// <returns>Selection settings with the bias and most detailed level of the tier</returns>
+	inline LODSelectionSettings MakeShadowLODSelectionSettings(const ShadowSettings& settings) noexcept
+	{
+		LODSelectionSettings selection;
+		switch (settings.quality)
+		{
+		case ShadowSettings::ShadowQuality::low:
+			selection.bias = 0.25f;
+			selection.minLevel = 2;
+			break;
+		case ShadowSettings::ShadowQuality::medium:
+			selection.bias = 0.5f;
+			selection.minLevel = 1;
+			break;
+		case ShadowSettings::ShadowQuality::high:
+			selection.bias = 0.75f;
+			break;
+		case ShadowSettings::ShadowQuality::ultra:
+			selection.bias = 1.0f;
+			break;
+		}
+
+		return selection;
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_IRENDERER_LOD_H
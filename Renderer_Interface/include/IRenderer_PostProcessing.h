@@ -0,0 +1,45 @@
+#ifndef ULTREALITY_RENDERING_IRENDERER_POST_PROCESSING_H
+#define ULTREALITY_RENDERING_IRENDERER_POST_PROCESSING_H
+
+#include <algorithm>
+
+#include <PostProcessChain.h>
+
+#include <IRenderer_Settings.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Merge the post-processing and lighting settings into the settings of the fused post-processing chain
+	/// </summary>
+	/// <param name="postProcessing">The renderer's post-processing settings</param>
+	/// <param name="lighting">The renderer's lighting settings. Its bloom flag enables the same bloom as the post-processing one</param>
+	/// <returns>Settings with each enabled effect applied once, so bloom is never run twice</returns>
+	inline PostProcessSettings MakePostProcessSettings(const PostProcessingSettings& postProcessing, const LightingSettings& lighting) noexcept
+	{
+		PostProcessSettings settings;
+
+		settings.bloom = postProcessing.bloom || lighting.bloom;
+		if (settings.bloom)
+		{
+			const uint8_t intensity = std::max(postProcessing.bloom ? postProcessing.bloomIntensity : uint8_t(0), lighting.bloom ? lighting.bloomIntensity : uint8_t(0));
+			settings.bloomIntensity = intensity / 255.0f;
+			settings.bloomThreshold = lighting.hdr ? 1.0f : 0.8f; // Without HDR the scene never exceeds 1
+		}
+
+		settings.depthOfField = postProcessing.DOF && postProcessing.dofParams.focusRange > 0.0f && postProcessing.dofParams.maxBlurRadius > 0;
+		if (settings.depthOfField)
+		{
+			settings.focusDistance = postProcessing.dofParams.focusDistance;
+			settings.focusRange = postProcessing.dofParams.focusRange;
+			settings.maxBlurRadius = postProcessing.dofParams.maxBlurRadius;
+		}
+
+		settings.motionBlur = postProcessing.motionBlur && postProcessing.motionBlurIntensity > 0;
+		settings.motionBlurScale = postProcessing.motionBlurIntensity / 255.0f;
+
+		return settings;
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_IRENDERER_POST_PROCESSING_H
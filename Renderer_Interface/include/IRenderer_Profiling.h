@@ -1,6 +1,8 @@
 #ifndef ULTREALITY_RENDERING_IRENDERER_PROFILING_H
 #define ULTREALITY_RENDERING_IRENDERER_PROFILING_H
 
+#include <stddef.h>
+
 namespace UltReality::Rendering
 {
 	enum class GpuTimingPass
@@ -16,6 +18,8 @@ namespace UltReality::Rendering
 		Custom1,		// Reserved for user-defined passes
 		Custom2,		// Reserved for user-defined passes
 	};
+
+	constexpr size_t GpuTimingPassCount = static_cast<size_t>(GpuTimingPass::Custom2) + 1;
 }
 
 #endif // !ULTREALITY_RENDERING_IRENDERER_PROFILING_H
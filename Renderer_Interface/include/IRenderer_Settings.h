@@ -85,7 +85,9 @@ namespace UltReality::Rendering
 		bool DOF;
 		struct DOFParams
 		{
-
+			float focusDistance;	// View depth in focus
+			float focusRange;		// Distance from the focus plane at which the blur reaches maxBlurRadius
+			uint8_t maxBlurRadius;	// Largest blur radius, in pixels
 		};
 		DOFParams dofParams;
 		bool motionBlur;
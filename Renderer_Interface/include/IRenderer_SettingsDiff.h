@@ -0,0 +1,167 @@
+#ifndef ULTREALITY_RENDERING_IRENDERER_SETTINGS_DIFF_H
+#define ULTREALITY_RENDERING_IRENDERER_SETTINGS_DIFF_H
+
+#include <ResourceRebuilder.h>
+
+#include <IRenderer_Settings.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Resource groups a settings change can invalidate. Bits are ordered so groups only depend on lower bits, matching the
+	/// build order of <see cref="ResourceRebuilder"/>
+	/// </summary>
+	struct RenderResource
+	{
+		enum : RebuildMask
+		{
+			None = 0,
+			SwapChain = 1 << 0,			// Back buffers, screen mode and refresh rate
+			SceneTargets = 1 << 1,		// Color and depth targets at the render resolution, their format follows HDR
+			MSAATargets = 1 << 2,		// Multi-sampled color and depth targets
+			TemporalHistory = 1 << 3,	// Temporal upscaler history
+			ShadowMaps = 1 << 4,		// Cascade shadow maps and their static caches
+			LightingTargets = 1 << 5,	// Global illumination and ambient occlusion buffers
+			PostProcessTargets = 1 << 6,// Bloom and depth of field mip chains
+			Samplers = 1 << 7,			// Sampler states
+			TextureResidency = 1 << 8,	// Streamed texture mip levels
+			PipelineStates = 1 << 9,	// Pipeline state objects and the shader permutations they were compiled from
+
+			// Groups allocated at the render resolution. Without dynamic resolution that is the display resolution, with it the maximum
+			// render resolution, so changing either reallocates all of them
+			RenderResolutionTargets = SceneTargets | MSAATargets | TemporalHistory | LightingTargets | PostProcessTargets,
+
+			// Not rebuilt, the renderer picks the change up when it fills the next frame's constants or presents
+			FrameConstants = 1u << 31
+		};
+	};
+
+	/// <summary>
+	/// Get the resources invalidated by a display settings change
+	/// </summary>
+	/// <param name="current">Settings the resources were built with</param>
+	/// <param name="next">Settings being applied</param>
+	/// <returns>Mask of <see cref="RenderResource"/> groups to rebuild</returns>
+	inline RebuildMask DiffSettings(const DisplaySettings& current, const DisplaySettings& next) noexcept
+	{
+		RebuildMask mask = RenderResource::None;
+		if (current.resolution.width != next.resolution.width || current.resolution.height != next.resolution.height)
+			mask |= RenderResource::SwapChain | RenderResource::RenderResolutionTargets;
+		if (current.mode != next.mode || current.refreshRate != next.refreshRate)
+			mask |= RenderResource::SwapChain;
+		if (current.vSync != next.vSync)
+			mask |= RenderResource::FrameConstants; // Present interval only
+
+		return mask;
+	}
+
+	/// <summary>
+	/// Get the resources invalidated by an anti-aliasing settings change
+	/// </summary>
+	inline RebuildMask DiffSettings(const AntiAliasingSettings& current, const AntiAliasingSettings& next) noexcept
+	{
+		using AntiAliasingType = AntiAliasingSettings::AntiAliasingType;
+
+		RebuildMask mask = RenderResource::None;
+		if (current.type != next.type)
+		{
+			// Sample count is baked into the pipeline states
+			mask |= RenderResource::PipelineStates;
+			if (current.type == AntiAliasingType::MSAA || next.type == AntiAliasingType::MSAA)
+				mask |= RenderResource::MSAATargets;
+			if (current.type == AntiAliasingType::TAA || next.type == AntiAliasingType::TAA)
+				mask |= RenderResource::TemporalHistory;
+		}
+		else if (next.type == AntiAliasingType::MSAA && (current.sampleCount != next.sampleCount || current.qualityLevel != next.qualityLevel))
+			mask |= RenderResource::MSAATargets | RenderResource::PipelineStates;
+		else if (current.qualityLevel != next.qualityLevel)
+			mask |= RenderResource::FrameConstants;
+
+		return mask;
+	}
+
+	/// <summary>
+	/// Get the resources invalidated by a texture settings change
+	/// </summary>
+	inline RebuildMask DiffSettings(const TextureSettings& current, const TextureSettings& next) noexcept
+	{
+		RebuildMask mask = RenderResource::None;
+		if (current.filteringLevel != next.filteringLevel)
+			mask |= RenderResource::Samplers;
+		if (current.quality != next.quality)
+			mask |= RenderResource::TextureResidency;
+		if (current.mipmapping != next.mipmapping)
+			mask |= RenderResource::Samplers | RenderResource::TextureResidency;
+
+		return mask;
+	}
+
+	/// <summary>
+	/// Get the resources invalidated by a shadow settings change
+	/// </summary>
+	inline RebuildMask DiffSettings(const ShadowSettings& current, const ShadowSettings& next) noexcept
+	{
+		RebuildMask mask = RenderResource::None;
+		if (current.quality != next.quality || current.mapResolution != next.mapResolution)
+			mask |= RenderResource::ShadowMaps;
+		if (current.quality != next.quality || current.softShadows != next.softShadows)
+			mask |= RenderResource::PipelineStates; // Cascade count and filter kernel are shader permutations
+
+		return mask;
+	}
+
+	/// <summary>
+	/// Get the resources invalidated by a lighting settings change
+	/// </summary>
+	inline RebuildMask DiffSettings(const LightingSettings& current, const LightingSettings& next) noexcept
+	{
+		RebuildMask mask = RenderResource::None;
+		if (current.globalIllumination != next.globalIllumination || current.ambientOcclusion != next.ambientOcclusion)
+			mask |= RenderResource::LightingTargets | RenderResource::PipelineStates;
+		else if (next.ambientOcclusion && current.quality != next.quality)
+			mask |= RenderResource::LightingTargets | RenderResource::PipelineStates;
+		if (current.hdr != next.hdr)
+			mask |= RenderResource::SwapChain | RenderResource::SceneTargets | RenderResource::MSAATargets | RenderResource::TemporalHistory | RenderResource::PostProcessTargets | RenderResource::PipelineStates;
+		if (current.bloom != next.bloom)
+			mask |= RenderResource::PostProcessTargets | RenderResource::PipelineStates;
+		if (current.bloomIntensity != next.bloomIntensity)
+			mask |= RenderResource::FrameConstants;
+
+		return mask;
+	}
+
+	/// <summary>
+	/// Get the resources invalidated by a post-processing settings change
+	/// </summary>
+	inline RebuildMask DiffSettings(const PostProcessingSettings& current, const PostProcessingSettings& next) noexcept
+	{
+		RebuildMask mask = RenderResource::None;
+		if (current.bloom != next.bloom || current.DOF != next.DOF || current.motionBlur != next.motionBlur)
+			mask |= RenderResource::PostProcessTargets | RenderResource::PipelineStates;
+		else if (next.DOF && current.dofParams.maxBlurRadius != next.dofParams.maxBlurRadius)
+			mask |= RenderResource::PostProcessTargets; // Blur radius decides the depth of the mip chain
+		if (current.bloomIntensity != next.bloomIntensity || current.motionBlurIntensity != next.motionBlurIntensity
+			|| current.dofParams.focusDistance != next.dofParams.focusDistance || current.dofParams.focusRange != next.dofParams.focusRange)
+			mask |= RenderResource::FrameConstants;
+
+		return mask;
+	}
+
+	/// <summary>
+	/// Get the resources invalidated by a performance settings change
+	/// </summary>
+	inline RebuildMask DiffSettings(const PerformanceSettings& current, const PerformanceSettings& next) noexcept
+	{
+		RebuildMask mask = RenderResource::None;
+		if (current.dynamicResolution != next.dynamicResolution)
+			mask |= RenderResource::RenderResolutionTargets | RenderResource::PipelineStates;
+		else if (next.dynamicResolution && (current.maxResolution.width != next.maxResolution.width || current.maxResolution.height != next.maxResolution.height))
+			mask |= RenderResource::RenderResolutionTargets; // Targets are allocated at the largest render resolution
+		if (next.dynamicResolution && (current.minResolution.width != next.minResolution.width || current.minResolution.height != next.minResolution.height))
+			mask |= RenderResource::FrameConstants;
+
+		return mask;
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_IRENDERER_SETTINGS_DIFF_H
@@ -0,0 +1,48 @@
+#ifndef ULTREALITY_RENDERING_IRENDERER_SHADOWS_H
+#define ULTREALITY_RENDERING_IRENDERER_SHADOWS_H
+
+#include <CascadedShadows.h>
+
+#include <IRenderer_Settings.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Derive the cascade layout of the directional light's shadow maps from the shadow settings
+	/// </summary>
+	/// <param name="settings">The renderer's shadow settings</param>
+	/// <returns>Cascade settings for the quality tier at the requested map resolution</returns>
+	inline CascadedShadowSettings MakeCascadedShadowSettings(const ShadowSettings& settings) noexcept
+	{
+		CascadedShadowSettings cascades;
+		cascades.resolution = settings.mapResolution;
+
+		switch (settings.quality)
+		{
+		case ShadowSettings::ShadowQuality::low:
+			cascades.cascadeCount = 2;
+			cascades.maxDistance = 60.0f;
+			cascades.updateInterval = { 1, 4, 1, 1 };
+			break;
+		case ShadowSettings::ShadowQuality::medium:
+			cascades.cascadeCount = 3;
+			cascades.maxDistance = 120.0f;
+			cascades.updateInterval = { 1, 2, 4, 1 };
+			break;
+		case ShadowSettings::ShadowQuality::high:
+			cascades.cascadeCount = 4;
+			cascades.maxDistance = 200.0f;
+			cascades.updateInterval = { 1, 1, 2, 4 };
+			break;
+		case ShadowSettings::ShadowQuality::ultra:
+			cascades.cascadeCount = 4;
+			cascades.maxDistance = 400.0f;
+			cascades.updateInterval = { 1, 1, 1, 2 };
+			break;
+		}
+
+		return cascades;
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_IRENDERER_SHADOWS_H
@@ -0,0 +1,63 @@
+#ifndef ULTREALITY_RENDERING_IRENDERER_TEMPORAL_H
+#define ULTREALITY_RENDERING_IRENDERER_TEMPORAL_H
+
+#include <algorithm>
+
+#include <TemporalUpscaler.h>
+
+#include <IRenderer_Settings.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Check if the scene should be rendered through the temporal upscaler
+	/// </summary>
+	/// <param name="antiAliasing">The renderer's anti-aliasing settings</param>
+	/// <param name="performance">The renderer's performance settings</param>
+	/// <returns>True if TAA is selected, or dynamic resolution needs the upscaler to reconstruct the output resolution</returns>
+	inline bool UsesTemporalUpscaling(const AntiAliasingSettings& antiAliasing, const PerformanceSettings& performance) noexcept
+	{
+		return antiAliasing.type == AntiAliasingSettings::AntiAliasingType::TAA || performance.dynamicResolution;
+	}
+
+	/// <summary>
+	/// Derive the temporal upscaler settings from the anti-aliasing settings
+	/// </summary>
+	/// <param name="antiAliasing">The renderer's anti-aliasing settings. Higher quality levels accumulate over more frames</param>
+	inline TemporalUpscaleSettings MakeTemporalUpscaleSettings(const AntiAliasingSettings& antiAliasing) noexcept
+	{
+		TemporalUpscaleSettings settings;
+		settings.blendFactor = antiAliasing.qualityLevel >= 2 ? 0.05f : antiAliasing.qualityLevel == 1 ? 0.08f : 0.12f;
+
+		return settings;
+	}
+
+	/// <summary>
+	/// Get the resolution to render the scene at before upscaling to the display resolution
+	/// </summary>
+	/// <param name="display">The renderer's display settings, the output resolution</param>
+	/// <param name="performance">The renderer's performance settings</param>
+	/// <param name="scale">Fraction of the display resolution per axis requested by the frame time controller, ignored without dynamic resolution</param>
+	/// <returns>The render resolution, within the performance settings' bounds and never above the display resolution</returns>
+	inline Rectangle ComputeRenderResolution(const DisplaySettings& display, const PerformanceSettings& performance, float scale) noexcept
+	{
+		if (!performance.dynamicResolution)
+			return display.resolution;
+
+		const auto axis = [scale](uint16_t output, uint16_t minimum, uint16_t maximum)
+		{
+			const uint16_t upper = std::min(maximum ? maximum : output, output);
+			const uint16_t lower = std::min(std::max<uint16_t>(minimum, 1), upper);
+			const float scaled = static_cast<float>(output) * std::clamp(scale, 0.0f, 1.0f);
+
+			return static_cast<uint16_t>(std::clamp(scaled, static_cast<float>(lower), static_cast<float>(upper)));
+		};
+
+		return Rectangle{
+			axis(display.resolution.width, performance.minResolution.width, performance.maxResolution.width),
+			axis(display.resolution.height, performance.minResolution.height, performance.maxResolution.height)
+		};
+	}
+}
+
+#endif // !ULTREALITY_RENDERING_IRENDERER_TEMPORAL_H
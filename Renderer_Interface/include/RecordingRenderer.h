@@ -0,0 +1,470 @@
+#ifndef ULTREALITY_RENDERING_RECORDING_RENDERER_H
+#define ULTREALITY_RENDERING_RECORDING_RENDERER_H
+
+#include <exception>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include <IRenderer.h>
+#include <RenderCapture.h>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Decorator that forwards every call to another renderer and records the calls and their payloads into a capture for
+	/// <see cref="CaptureReplayer"/>. Const queries (hardware enumeration, settings getters, GPU timings) are forwarded without being recorded.
+	/// ReadBuffer records the bytes the wrapped renderer returned so replay can compare them
+	/// </summary>
+	class RecordingRenderer : public IRenderer
+	{
+	public:
+		/// <summary>
+		/// Computes the size in bytes of the data passed to CreateTexture, which the texture description alone does not define
+		/// (format, mip chain and array layout are up to the renderer)
+		/// </summary>
+		using TextureDataSize = std::function<size_t(const TextureDesc&)>;
+
+	protected:
+		struct Mapping
+		{
+			void* data;
+			size_t size;
+			MapType type;
+		};
+
+		IRenderer& m_target;
+		CaptureWriter m_writer;
+		TextureDataSize m_textureDataSize;
+		std::unordered_map<BufferHandle, Mapping> m_mappings;
+		std::exception_ptr m_writeError;	// Write failure in a noexcept call, rethrown by Flush
+
+		template<typename Settings>
+		void RecordSettings(CaptureCall call, CaptureSettings kind, const Settings& settings)
+		{
+			m_writer.Begin(call);
+			m_writer.Write(kind);
+			m_writer.Write(settings);
+			m_writer.End();
+		}
+
+		/// <summary>
+		/// Record from a noexcept call, keeping the first write failure for <see cref="Flush"/>
+		/// </summary>
+		template<typename Record>
+		void RecordNoexcept(Record&& record) noexcept
+		{
+			try
+			{
+				record();
+			}
+			catch (...)
+			{
+				if (!m_writeError)
+					m_writeError = std::current_exception();
+			}
+		}
+
+	public:
+		/// <summary>
+		/// Start recording. The wrapped renderer's current settings are recorded first so replay starts from the same state
+		/// </summary>
+		/// <param name="target">Renderer that executes the calls. Must outlive the recorder</param>
+		/// <param name="path">Capture file to create</param>
+		/// <param name="textureDataSize">Size of the initial data the target renderer reads in CreateTexture for a description, including every mip level and array slice</param>
+		/// <exception cref="std.invalid_argument">Thrown if textureDataSize is empty</exception>
+		/// <exception cref="std.runtime_error">Thrown if the capture file can not be created</exception>
+		RecordingRenderer(IRenderer& target, const std::filesystem::path& path, TextureDataSize textureDataSize)
+			: m_target(target), m_writer(path), m_textureDataSize(std::move(textureDataSize))
+		{
+			if (!m_textureDataSize)
+				throw std::invalid_argument("RecordingRenderer needs the size of CreateTexture initial data");
+
+			m_displaySettings = target.GetDisplaySettings();
+			m_antiAliasingSettings = target.GetAntiAliasingSettings();
+			m_textureSettings = target.GetTextureSettings();
+			m_shadowSettings = target.GetShadowSettings();
+			m_lightingSettings = target.GetLightingSettings();
+			m_postProcessingSettings = target.GetPostProcessingSettings();
+			m_performanceSettings = target.GetPerformanceSettings();
+
+			RecordSettings(CaptureCall::InitSettings, CaptureSettings::Display, m_displaySettings);
+			RecordSettings(CaptureCall::InitSettings, CaptureSettings::AntiAliasing, m_antiAliasingSettings);
+			RecordSettings(CaptureCall::InitSettings, CaptureSettings::Texture, m_textureSettings);
+			RecordSettings(CaptureCall::InitSettings, CaptureSettings::Shadow, m_shadowSettings);
+			RecordSettings(CaptureCall::InitSettings, CaptureSettings::Lighting, m_lightingSettings);
+			RecordSettings(CaptureCall::InitSettings, CaptureSettings::PostProcessing, m_postProcessingSettings);
+			RecordSettings(CaptureCall::InitSettings, CaptureSettings::Performance, m_performanceSettings);
+		}
+
+		/// <summary>
+		/// Write buffered records to the capture file
+		/// </summary>
+		/// <exception cref="std.runtime_error">Thrown if writing failed, including failures of earlier noexcept calls</exception>
+		void Flush()
+		{
+			if (m_writeError)
+				std::rethrow_exception(std::exchange(m_writeError, nullptr));
+
+			m_writer.Flush();
+		}
+
+		void RENDERER_INTERFACE_CALL Initialize(DisplayTarget viewport) override
+		{
+			// The window handle is meaningless in another process, replay supplies its own target
+			m_writer.Begin(CaptureCall::Initialize);
+			m_writer.End();
+
+			m_target.Initialize(viewport);
+		}
+
+		BufferHandle RENDERER_INTERFACE_CALL CreateBuffer(const void* data, size_t size, BufferUsage usage, BufferType type, BufferMemoryType memType) override
+		{
+			const BufferHandle handle = m_target.CreateBuffer(data, size, usage, type, memType);
+
+			m_writer.Begin(CaptureCall::CreateBuffer);
+			m_writer.Write(handle);
+			m_writer.Write(usage);
+			m_writer.Write(type);
+			m_writer.Write(memType);
+			m_writer.WriteSize(size);
+			m_writer.Write<uint8_t>(data != nullptr);
+			if (data)
+				m_writer.WriteBytes(data, size);
+			m_writer.End();
+
+			return handle;
+		}
+
+		BufferHandle RENDERER_INTERFACE_CALL CreateVertexBuffer(const void* data, size_t size, const VertexLayout& layout, BufferUsage usage, BufferMemoryType memType) override
+		{
+			const BufferHandle handle = m_target.CreateVertexBuffer(data, size, layout, usage, memType);
+
+			m_writer.Begin(CaptureCall::CreateVertexBuffer);
+			m_writer.Write(handle);
+			m_writer.Write(usage);
+			m_writer.Write(memType);
+			m_writer.Write(static_cast<uint8_t>(layout.GetAttributeCount()));
+			for (size_t i = 0; i < layout.GetAttributeCount(); i++)
+			{
+				const VertexAttribute& attribute = layout.GetAttribute(i);
+				m_writer.Write(attribute.semantic);
+				m_writer.Write(attribute.semanticIndex);
+				m_writer.Write(attribute.format);
+			}
+			m_writer.Write(layout.GetPositionBounds());
+			m_writer.WriteSize(size);
+			m_writer.Write<uint8_t>(data != nullptr);
+			if (data)
+				m_writer.WriteBytes(data, size);
+			m_writer.End();
+
+			return handle;
+		}
+
+		void RENDERER_INTERFACE_CALL UpdateBuffer(BufferHandle handle, const void* data, size_t size, size_t offset = 0) override
+		{
+			m_writer.Begin(CaptureCall::UpdateBuffer);
+			m_writer.Write(handle);
+			m_writer.WriteSize(offset);
+			m_writer.WriteSize(size);
+			m_writer.WriteBytes(data, size);
+			m_writer.End();
+
+			m_target.UpdateBuffer(handle, data, size, offset);
+		}
+
+		void RENDERER_INTERFACE_CALL DestroyBuffer(BufferHandle handle) override
+		{
+			m_writer.Begin(CaptureCall::DestroyBuffer);
+			m_writer.Write(handle);
+			m_writer.End();
+
+			m_target.DestroyBuffer(handle);
+		}
+
+		void* RENDERER_INTERFACE_CALL MapBuffer(BufferHandle handle, size_t size, size_t offset, MapType mapType) override
+		{
+			void* data = m_target.MapBuffer(handle, size, offset, mapType);
+			m_mappings[handle] = Mapping{ data, size, mapType };
+
+			m_writer.Begin(CaptureCall::MapBuffer);
+			m_writer.Write(handle);
+			m_writer.WriteSize(size);
+			m_writer.WriteSize(offset);
+			m_writer.Write(mapType);
+			m_writer.End();
+
+			return data;
+		}
+
+		void RENDERER_INTERFACE_CALL UnmapBuffer(BufferHandle handle) override
+		{
+			// What the application wrote through the mapping is only known once it is done with it
+			m_writer.Begin(CaptureCall::UnmapBuffer);
+			m_writer.Write(handle);
+			const auto mapping = m_mappings.find(handle);
+			if (mapping != m_mappings.end() && mapping->second.type == MapType::Write && mapping->second.data)
+			{
+				m_writer.WriteSize(mapping->second.size);
+				m_writer.WriteBytes(mapping->second.data, mapping->second.size);
+			}
+			else
+				m_writer.WriteSize(0);
+			m_writer.End();
+
+			if (mapping != m_mappings.end())
+				m_mappings.erase(mapping);
+
+			m_target.UnmapBuffer(handle);
+		}
+
+		void RENDERER_INTERFACE_CALL ReadBuffer(BufferHandle handle, void* destination, size_t size, size_t offset = 0) override
+		{
+			m_target.ReadBuffer(handle, destination, size, offset);
+
+			m_writer.Begin(CaptureCall::ReadBuffer);
+			m_writer.Write(handle);
+			m_writer.WriteSize(size);
+			m_writer.WriteSize(offset);
+			m_writer.WriteBytes(destination, size);
+			m_writer.End();
+		}
+
+		TextureHandle RENDERER_INTERFACE_CALL CreateTexture(const TextureDesc& desc, const void* initialData) override
+		{
+			const TextureHandle handle = m_target.CreateTexture(desc, initialData);
+
+			m_writer.Begin(CaptureCall::CreateTexture);
+			m_writer.Write(handle);
+			m_writer.Write(desc);
+			const size_t size = initialData ? m_textureDataSize(desc) : 0;
+			m_writer.WriteSize(size);
+			m_writer.WriteBytes(initialData, size);
+			m_writer.End();
+
+			return handle;
+		}
+
+		void RENDERER_INTERFACE_CALL UpdateTexture(TextureHandle handle, const void* data, size_t size, const TextureUpdateDesc& regionDesc) override
+		{
+			m_writer.Begin(CaptureCall::UpdateTexture);
+			m_writer.Write(handle);
+			m_writer.Write(regionDesc);
+			m_writer.WriteSize(size);
+			m_writer.WriteBytes(data, size);
+			m_writer.End();
+
+			m_target.UpdateTexture(handle, data, size, regionDesc);
+		}
+
+		void RENDERER_INTERFACE_CALL DestroyTexture(TextureHandle handle) override
+		{
+			m_writer.Begin(CaptureCall::DestroyTexture);
+			m_writer.Write(handle);
+			m_writer.End();
+
+			m_target.DestroyTexture(handle);
+		}
+
+		ShaderHandle RENDERER_INTERFACE_CALL CreateShaderFromSource(const std::string& source, ShaderType type) override
+		{
+			const ShaderHandle handle = m_target.CreateShaderFromSource(source, type);
+
+			m_writer.Begin(CaptureCall::CreateShaderFromSource);
+			m_writer.Write(handle);
+			m_writer.Write(type);
+			m_writer.WriteString(source);
+			m_writer.End();
+
+			return handle;
+		}
+
+		ShaderHandle RENDERER_INTERFACE_CALL CreateShaderFromSource(const std::filesystem::path& filePath, ShaderType type) override
+		{
+			const ShaderHandle handle = m_target.CreateShaderFromSource(filePath, type);
+
+			m_writer.Begin(CaptureCall::CreateShaderFromFile);
+			m_writer.Write(handle);
+			m_writer.Write(type);
+			m_writer.WriteString(filePath.string());
+			m_writer.End();
+
+			return handle;
+		}
+
+		ShaderHandle RENDERER_INTERFACE_CALL CreateShaderFromBinary(const std::string& filePath, ShaderType type) override
+		{
+			const ShaderHandle handle = m_target.CreateShaderFromBinary(filePath, type);
+
+			m_writer.Begin(CaptureCall::CreateShaderFromBinary);
+			m_writer.Write(handle);
+			m_writer.Write(type);
+			m_writer.WriteString(filePath);
+			m_writer.End();
+
+			return handle;
+		}
+
+		void RENDERER_INTERFACE_CALL DestroyShader(ShaderHandle handle) override
+		{
+			m_writer.Begin(CaptureCall::DestroyShader);
+			m_writer.Write(handle);
+			m_writer.End();
+
+			m_target.DestroyShader(handle);
+		}
+
+		void RENDERER_INTERFACE_CALL Render() override
+		{
+			m_writer.Begin(CaptureCall::Render);
+			m_writer.End();
+
+			m_target.Render();
+		}
+
+		void RENDERER_INTERFACE_CALL Present() override
+		{
+			m_writer.Begin(CaptureCall::Present);
+			m_writer.End();
+
+			m_target.Present();
+		}
+
+		void RENDERER_INTERFACE_CALL FlushCommandQueue() override
+		{
+			m_writer.Begin(CaptureCall::FlushCommandQueue);
+			m_writer.End();
+
+			m_target.FlushCommandQueue();
+		}
+
+		std::vector<AdapterDesc> RENDERER_INTERFACE_CALL GetDisplayAdapters() const override
+		{
+			return m_target.GetDisplayAdapters();
+		}
+
+		std::vector<OutputDesc> RENDERER_INTERFACE_CALL GetOutputsForAdapter(const AdapterDesc& adapter) const override
+		{
+			return m_target.GetOutputsForAdapter(adapter);
+		}
+
+		std::vector<DisplayMode> RENDERER_INTERFACE_CALL GetDisplayModesForOutput(const OutputDesc& output) const override
+		{
+			return m_target.GetDisplayModesForOutput(output);
+		}
+
+		void RENDERER_INTERFACE_CALL SetDisplaySettings(const DisplaySettings& settings) override
+		{
+			RecordSettings(CaptureCall::SetSettings, CaptureSettings::Display, settings);
+			m_target.SetDisplaySettings(settings);
+			m_displaySettings = settings;
+		}
+
+		void RENDERER_INTERFACE_CALL SetAntiAliasingSettings(const AntiAliasingSettings& settings) override
+		{
+			RecordSettings(CaptureCall::SetSettings, CaptureSettings::AntiAliasing, settings);
+			m_target.SetAntiAliasingSettings(settings);
+			m_antiAliasingSettings = settings;
+		}
+
+		void RENDERER_INTERFACE_CALL SetTextureSettings(const TextureSettings& settings) override
+		{
+			RecordSettings(CaptureCall::SetSettings, CaptureSettings::Texture, settings);
+			m_target.SetTextureSettings(settings);
+			m_textureSettings = settings;
+		}
+
+		void RENDERER_INTERFACE_CALL SetShadowSettings(const ShadowSettings& settings) override
+		{
+			RecordSettings(CaptureCall::SetSettings, CaptureSettings::Shadow, settings);
+			m_target.SetShadowSettings(settings);
+			m_shadowSettings = settings;
+		}
+
+		void RENDERER_INTERFACE_CALL SetLightingSettings(const LightingSettings& settings) override
+		{
+			RecordSettings(CaptureCall::SetSettings, CaptureSettings::Lighting, settings);
+			m_target.SetLightingSettings(settings);
+			m_lightingSettings = settings;
+		}
+
+		void RENDERER_INTERFACE_CALL SetPostProcessingSettings(const PostProcessingSettings& settings) override
+		{
+			RecordSettings(CaptureCall::SetSettings, CaptureSettings::PostProcessing, settings);
+			m_target.SetPostProcessingSettings(settings);
+			m_postProcessingSettings = settings;
+		}
+
+		void RENDERER_INTERFACE_CALL SetPerformanceSettings(const PerformanceSettings& settings) override
+		{
+			RecordSettings(CaptureCall::SetSettings, CaptureSettings::Performance, settings);
+			m_target.SetPerformanceSettings(settings);
+			m_performanceSettings = settings;
+		}
+
+		void RENDERER_INTERFACE_CALL EnableGPUProfiling(bool enable) noexcept override
+		{
+			RecordNoexcept([&]
+			{
+				m_writer.Begin(CaptureCall::EnableGPUProfiling);
+				m_writer.Write<uint8_t>(enable);
+				m_writer.End();
+			});
+
+			m_target.EnableGPUProfiling(enable);
+		}
+
+		bool RENDERER_INTERFACE_CALL IsGpuProfilingEnabled() const noexcept override
+		{
+			return m_target.IsGpuProfilingEnabled();
+		}
+
+		void RENDERER_INTERFACE_CALL BeginGpuTimer(GpuTimingPass pass) noexcept override
+		{
+			RecordNoexcept([&]
+			{
+				m_writer.Begin(CaptureCall::BeginGpuTimer);
+				m_writer.Write(pass);
+				m_writer.End();
+			});
+
+			m_target.BeginGpuTimer(pass);
+		}
+
+		void RENDERER_INTERFACE_CALL EndGpuTimer(GpuTimingPass pass) noexcept override
+		{
+			RecordNoexcept([&]
+			{
+				m_writer.Begin(CaptureCall::EndGpuTimer);
+				m_writer.Write(pass);
+				m_writer.End();
+			});
+
+			m_target.EndGpuTimer(pass);
+		}
+
+		float RENDERER_INTERFACE_CALL GetGpuFrameTime() const noexcept override
+		{
+			return m_target.GetGpuFrameTime();
+		}
+
+		float RENDERER_INTERFACE_CALL GetGpuTimeForPass(GpuTimingPass pass) const noexcept override
+		{
+			return m_target.GetGpuTimeForPass(pass);
+		}
+
+		void RENDERER_INTERFACE_CALL ResetGpuTimers() noexcept override
+		{
+			RecordNoexcept([&]
+			{
+				m_writer.Begin(CaptureCall::ResetGpuTimers);
+				m_writer.End();
+			});
+
+			m_target.ResetGpuTimers();
+		}
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_RECORDING_RENDERER_H
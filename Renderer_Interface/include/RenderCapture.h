@@ -0,0 +1,288 @@
+#ifndef ULTREALITY_RENDERING_RENDER_CAPTURE_H
+#define ULTREALITY_RENDERING_RENDER_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace UltReality::Rendering
+{
+	/// <summary>
+	/// Renderer calls stored in a capture, one per record
+	/// </summary>
+	enum class CaptureCall : uint8_t
+	{
+		Initialize,
+		InitSettings,	// Settings the wrapped renderer held when recording started
+		CreateBuffer,
+		CreateVertexBuffer,
+		UpdateBuffer,
+		DestroyBuffer,
+		MapBuffer,
+		UnmapBuffer,	// Carries the bytes written through a write mapping
+		ReadBuffer,
+		CreateTexture,
+		UpdateTexture,
+		DestroyTexture,
+		CreateShaderFromSource,
+		CreateShaderFromFile,
+		CreateShaderFromBinary,
+		DestroyShader,
+		Render,
+		Present,
+		FlushCommandQueue,
+		SetSettings,
+		EnableGPUProfiling,
+		BeginGpuTimer,
+		EndGpuTimer,
+		ResetGpuTimers,
+		Count
+	};
+
+	/// <summary>
+	/// Settings struct carried by the InitSettings and SetSettings records
+	/// </summary>
+	enum class CaptureSettings : uint8_t
+	{
+		Display,
+		AntiAliasing,
+		Texture,
+		Shadow,
+		Lighting,
+		PostProcessing,
+		Performance
+	};
+
+	inline const char* CaptureCallName(CaptureCall call) noexcept
+	{
+		static constexpr const char* names[] = {
+			"Initialize", "InitSettings", "CreateBuffer", "CreateVertexBuffer", "UpdateBuffer", "DestroyBuffer", "MapBuffer", "UnmapBuffer",
+			"ReadBuffer", "CreateTexture", "UpdateTexture", "DestroyTexture", "CreateShaderFromSource", "CreateShaderFromFile",
+			"CreateShaderFromBinary", "DestroyShader", "Render", "Present", "FlushCommandQueue", "SetSettings", "EnableGPUProfiling",
+			"BeginGpuTimer", "EndGpuTimer", "ResetGpuTimers"
+		};
+		static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(CaptureCall::Count));
+
+		return call < CaptureCall::Count ? names[static_cast<size_t>(call)] : "Unknown";
+	}
+
+	/// <summary>
+	/// Layout of a capture file. A header of Magic and Version, followed by records of a CaptureCall byte, a 64-bit payload size and the payload.
+	/// Values are stored in the recording machine's byte order, sizes as 64-bit, and settings structs in their in-memory representation,
+	/// so a capture replays on builds with the same settings layout
+	/// </summary>
+	struct CaptureFormat
+	{
+		static constexpr char Magic[4] = { 'U', 'R', 'C', 'P' };
+		static constexpr uint32_t Version = 3;
+		static constexpr size_t HeaderSize = sizeof(Magic) + sizeof(Version);
+		static constexpr size_t RecordHeaderSize = sizeof(CaptureCall) + sizeof(uint64_t);
+	};
+
+	/// <summary>
+	/// Writes capture records. Each record's payload is assembled in memory between <see cref="Begin"/> and <see cref="End"/>
+	/// </summary>
+	class CaptureWriter
+	{
+	protected:
+		std::ofstream m_file;
+		std::vector<uint8_t> m_payload;
+		CaptureCall m_call = CaptureCall::Count;
+
+	public:
+		/// <summary>
+		/// Create the capture file and write its header
+		/// </summary>
+		/// <exception cref="std.runtime_error">Thrown if the file can not be created</exception>
+		explicit CaptureWriter(const std::filesystem::path& path) : m_file(path, std::ios::binary | std::ios::trunc)
+		{
+			if (!m_file)
+				throw std::runtime_error("Failed to create capture file " + path.string());
+
+			m_file.write(CaptureFormat::Magic, sizeof(CaptureFormat::Magic));
+			m_file.write(reinterpret_cast<const char*>(&CaptureFormat::Version), sizeof(CaptureFormat::Version));
+			if (!m_file)
+				throw std::runtime_error("Failed to write capture file header " + path.string());
+		}
+
+		void Begin(CaptureCall call) noexcept
+		{
+			m_call = call;
+			m_payload.clear();
+		}
+
+		template<typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written to a capture");
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void WriteBytes(const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			m_payload.insert(m_payload.end(), bytes, bytes + size);
+		}
+
+		void WriteSize(size_t size)
+		{
+			Write(static_cast<uint64_t>(size));
+		}
+
+		void WriteString(const std::string& value)
+		{
+			WriteSize(value.size());
+			WriteBytes(value.data(), value.size());
+		}
+
+		/// <summary>
+		/// Write the record assembled since <see cref="Begin"/>
+		/// </summary>
+		/// <exception cref="std.runtime_error">Thrown if the record could not be written</exception>
+		void End()
+		{
+			const uint64_t size = m_payload.size();
+			m_file.write(reinterpret_cast<const char*>(&m_call), sizeof(m_call));
+			m_file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+			m_file.write(reinterpret_cast<const char*>(m_payload.data()), static_cast<std::streamsize>(m_payload.size()));
+			if (!m_file)
+				throw std::runtime_error(std::string("Failed to write ") + CaptureCallName(m_call) + " capture record");
+		}
+
+		/// <exception cref="std.runtime_error">Thrown if buffered records could not be written</exception>
+		void Flush()
+		{
+			m_file.flush();
+			if (!m_file)
+				throw std::runtime_error("Failed to flush capture file");
+		}
+	};
+
+	/// <summary>
+	/// Reads values from a record's payload in the order they were written
+	/// </summary>
+	class PayloadReader
+	{
+	protected:
+		const uint8_t* m_data;
+		size_t m_size;
+		size_t m_cursor = 0;
+
+	public:
+		PayloadReader(const uint8_t* data, size_t size) noexcept : m_data(data), m_size(size)
+		{}
+
+		/// <exception cref="std.runtime_error">Thrown if the payload is shorter than requested</exception>
+		const uint8_t* ReadBytes(size_t size)
+		{
+			if (size > m_size - m_cursor)
+				throw std::runtime_error("Capture payload is truncated");
+
+			const uint8_t* bytes = m_data + m_cursor;
+			m_cursor += size;
+
+			return bytes;
+		}
+
+		template<typename T>
+		T Read()
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read from a capture");
+			T value;
+			std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+
+			return value;
+		}
+
+		size_t ReadSize()
+		{
+			return static_cast<size_t>(Read<uint64_t>());
+		}
+
+		std::string ReadString()
+		{
+			const size_t size = ReadSize();
+			const uint8_t* bytes = ReadBytes(size);
+
+			return std::string(reinterpret_cast<const char*>(bytes), size);
+		}
+	};
+
+	struct CaptureRecord
+	{
+		CaptureCall call;
+		const uint8_t* payload;
+		uint64_t size;
+	};
+
+	/// <summary>
+	/// Loads a whole capture into memory so replay does not wait on file reads
+	/// </summary>
+	class CaptureReader
+	{
+	protected:
+		std::vector<uint8_t> m_data;
+		size_t m_cursor = CaptureFormat::HeaderSize;
+
+	public:
+		/// <exception cref="std.runtime_error">Thrown if the file can not be read or is not a capture of this version</exception>
+		explicit CaptureReader(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				throw std::runtime_error("Failed to open capture file " + path.string());
+
+			m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+			uint32_t version = 0;
+			if (m_data.size() >= CaptureFormat::HeaderSize)
+				std::memcpy(&version, m_data.data() + sizeof(CaptureFormat::Magic), sizeof(version));
+			if (m_data.size() < CaptureFormat::HeaderSize || std::memcmp(m_data.data(), CaptureFormat::Magic, sizeof(CaptureFormat::Magic)) != 0 || version != CaptureFormat::Version)
+				throw std::runtime_error("File is not a supported render capture: " + path.string());
+		}
+
+		/// <summary>
+		/// Return to the first record
+		/// </summary>
+		void Rewind() noexcept
+		{
+			m_cursor = CaptureFormat::HeaderSize;
+		}
+
+		/// <summary>
+		/// Get the next record. Its payload stays valid for the lifetime of the reader
+		/// </summary>
+		/// <returns>False at the end of the capture</returns>
+		/// <exception cref="std.runtime_error">Thrown if the last record is truncated or has an unknown call</exception>
+		bool Next(CaptureRecord& record)
+		{
+			if (m_cursor == m_data.size())
+				return false;
+			if (m_data.size() - m_cursor < CaptureFormat::RecordHeaderSize)
+				throw std::runtime_error("Capture record is truncated");
+
+			std::memcpy(&record.call, m_data.data() + m_cursor, sizeof(record.call));
+			std::memcpy(&record.size, m_data.data() + m_cursor + sizeof(record.call), sizeof(record.size));
+			m_cursor += CaptureFormat::RecordHeaderSize;
+
+			if (record.call >= CaptureCall::Count)
+				throw std::runtime_error("Capture record has an unknown call");
+			if (m_data.size() - m_cursor < record.size)
+				throw std::runtime_error("Capture record is truncated");
+
+			record.payload = m_data.data() + m_cursor;
+			m_cursor += static_cast<size_t>(record.size);
+
+			return true;
+		}
+	};
+}
+
+#endif // !ULTREALITY_RENDERING_RENDER_CAPTURE_H
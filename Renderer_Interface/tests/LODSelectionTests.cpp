@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <IRenderer_LOD.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace UltReality::Rendering;
+namespace Math = UltReality::Math;
+
+namespace
+{
+	constexpr float ProjectionScale = 1.7320508f; // 60 degree vertical field of view
+	constexpr uint8_t LevelCount = 6;
+
+	struct TestObject
+	{
+		Math::Float3 center;
+		float radius;
+	};
+
+	// Objects along a sweep of distances, including the exact distances each threshold switches at, padded to whole SIMD lanes
+	std::vector<TestObject> MakeObjects(const LODSelectionSettings& settings)
+	{
+		std::vector<TestObject> objects;
+		for (int i = 0; i < 200; i++)
+		{
+			const float distance = 0.5f * std::pow(1.05f, static_cast<float>(i));
+			objects.push_back(TestObject{ Math::Float3{ 0.3f * distance, -0.2f * distance, distance }, 1.0f + 0.01f * (i % 7) });
+		}
+		for (const float threshold : settings.thresholds)
+		{
+			const float distance = ProjectionScale * settings.bias / threshold;
+			for (const float offset : { -1e-4f, 0.0f, 1e-4f })
+				objects.push_back(TestObject{ Math::Float3{ 0.0f, 0.0f, distance * (1.0f + offset) }, 1.0f });
+		}
+		while (objects.size() % 4 != 0)
+			objects.push_back(objects.back());
+
+		return objects;
+	}
+
+	std::vector<LODSelectionSettings> MakeTiers()
+	{
+		std::vector<LODSelectionSettings> tiers;
+		for (const auto quality : { TextureSettings::TextureQuality::low, TextureSettings::TextureQuality::medium, TextureSettings::TextureQuality::high, TextureSettings::TextureQuality::ultra })
+		{
+			TextureSettings settings{};
+			settings.quality = quality;
+			tiers.push_back(MakeLODSelectionSettings(settings));
+		}
+		for (const auto quality : { ShadowSettings::ShadowQuality::low, ShadowSettings::ShadowQuality::medium, ShadowSettings::ShadowQuality::high, ShadowSettings::ShadowQuality::ultra })
+		{
+			ShadowSettings settings{};
+			settings.quality = quality;
+			tiers.push_back(MakeShadowLODSelectionSettings(settings));
+		}
+
+		return tiers;
+	}
+}
+
+TEST(LODSelection, BatchedAndSingleSelectionAgreeOnEveryTier)
+{
+	const Math::Float3 camera{ 0.0f, 0.0f, 0.0f };
+	for (const LODSelectionSettings& settings : MakeTiers())
+	{
+		const std::vector<TestObject> objects = MakeObjects(settings);
+
+		// A whole number of 4-wide lanes goes through the vectorized loop, a single object through the scalar tail
+		LODSelector batched;
+		for (const TestObject& object : objects)
+			batched.AddObject(object.center, object.radius, LevelCount);
+		std::vector<uint8_t> levels;
+		batched.Select(camera, ProjectionScale, settings, levels);
+		ASSERT_EQ(levels.size(), objects.size());
+
+		LODSelector single;
+		single.AddObject(camera, 1.0f, LevelCount);
+		std::vector<uint8_t> singleLevel;
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			single.SetBounds(0, objects[i].center, objects[i].radius);
+			single.Select(camera, ProjectionScale, settings, singleLevel);
+			ASSERT_EQ(levels[i], singleLevel[0]) << "object " << i << " bias " << settings.bias;
+		}
+	}
+}
+
+TEST(LODSelection, LevelsFollowDistanceAndTierLimits)
+{
+	const std::vector<LODSelectionSettings> tiers = MakeTiers();
+
+	LODSelector selector;
+	for (int i = 0; i < 64; i++)
+		selector.AddObject(Math::Float3{ 0.0f, 0.0f, 1.0f + static_cast<float>(i * i) }, 1.0f, LevelCount);
+
+	std::vector<std::vector<uint8_t>> levels(tiers.size());
+	for (size_t tier = 0; tier < tiers.size(); tier++)
+	{
+		selector.Select(Math::Float3{ 0.0f, 0.0f, 0.0f }, ProjectionScale, tiers[tier], levels[tier]);
+		for (size_t i = 0; i < levels[tier].size(); i++)
+		{
+			EXPECT_GE(levels[tier][i], tiers[tier].minLevel);
+			EXPECT_LT(levels[tier][i], LevelCount);
+			if (i > 0)
+			{
+				EXPECT_GE(levels[tier][i], levels[tier][i - 1]) << "tier " << tier << " object " << i;
+			}
+		}
+		EXPECT_EQ(levels[tier].front(), tiers[tier].minLevel);
+		EXPECT_EQ(levels[tier].back(), LevelCount - 1);
+	}
+
+	// Higher quality tiers never pick a coarser level than lower ones, texture tiers 0-3 then shadow tiers 4-7
+	for (size_t tier = 1; tier < tiers.size(); tier++)
+	{
+		if (tier == 4)
+			continue;
+		for (size_t i = 0; i < levels[tier].size(); i++)
+			EXPECT_LE(levels[tier][i], levels[tier - 1][i]) << "tier " << tier << " object " << i;
+	}
+}
@@ -0,0 +1,362 @@
+#include <gtest/gtest.h>
+
+#include <CaptureReplayer.h>
+#include <RecordingRenderer.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace UltReality::Rendering;
+
+namespace
+{
+	struct MockCall
+	{
+		std::string name;
+		uint64_t handle;
+		std::vector<uint8_t> bytes;
+	};
+
+	/// <summary>
+	/// Renderer that hands out handles from a counter, logs every call with the bytes it received and serves reads from a fixed pattern
+	/// </summary>
+	class MockRenderer : public IRenderer
+	{
+	public:
+		std::vector<MockCall> calls;
+		uint64_t nextHandle;
+		uint8_t readPattern = 0x40;
+		std::vector<uint8_t> mapped = std::vector<uint8_t>(64, 0);
+		bool profiling = false;
+		std::chrono::milliseconds renderDelay{ 0 };
+
+		explicit MockRenderer(uint64_t firstHandle) : nextHandle(firstHandle)
+		{}
+
+		void Log(const char* name, uint64_t handle = 0, const void* data = nullptr, size_t size = 0)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			calls.push_back(MockCall{ name, handle, bytes ? std::vector<uint8_t>(bytes, bytes + size) : std::vector<uint8_t>() });
+		}
+
+		void Initialize(DisplayTarget) override { Log("Initialize"); }
+		BufferHandle CreateBuffer(const void* data, size_t size, BufferUsage, BufferType, BufferMemoryType) override { Log("CreateBuffer", nextHandle, data, size); return nextHandle++; }
+		BufferHandle CreateVertexBuffer(const void* data, size_t size, const VertexLayout& layout, BufferUsage, BufferMemoryType) override
+		{
+			Log("CreateVertexBuffer", nextHandle, data, size);
+			calls.back().bytes.push_back(static_cast<uint8_t>(layout.GetStride()));
+			const uint8_t* bounds = reinterpret_cast<const uint8_t*>(&layout.GetPositionBounds());
+			calls.back().bytes.insert(calls.back().bytes.end(), bounds, bounds + sizeof(VertexBounds));
+			return nextHandle++;
+		}
+		void UpdateBuffer(BufferHandle handle, const void* data, size_t size, size_t) override { Log("UpdateBuffer", handle, data, size); }
+		void DestroyBuffer(BufferHandle handle) override { Log("DestroyBuffer", handle); }
+		void* MapBuffer(BufferHandle handle, size_t, size_t, MapType) override { Log("MapBuffer", handle); return mapped.data(); }
+		void UnmapBuffer(BufferHandle handle) override { Log("UnmapBuffer", handle, mapped.data(), mapped.size()); }
+		void ReadBuffer(BufferHandle handle, void* destination, size_t size, size_t offset) override
+		{
+			uint8_t* bytes = static_cast<uint8_t*>(destination);
+			for (size_t i = 0; i < size; i++)
+				bytes[i] = static_cast<uint8_t>(readPattern + offset + i);
+			Log("ReadBuffer", handle);
+		}
+		TextureHandle CreateTexture(const TextureDesc&, const void* initialData) override { Log("CreateTexture", nextHandle, initialData, initialData ? 32 : 0); return nextHandle++; }
+		void UpdateTexture(TextureHandle handle, const void* data, size_t size, const TextureUpdateDesc&) override { Log("UpdateTexture", handle, data, size); }
+		void DestroyTexture(TextureHandle handle) override { Log("DestroyTexture", handle); }
+		ShaderHandle CreateShaderFromSource(const std::string& source, ShaderType) override { Log("CreateShaderFromSource", nextHandle, source.data(), source.size()); return nextHandle++; }
+		ShaderHandle CreateShaderFromSource(const std::filesystem::path&, ShaderType) override { Log("CreateShaderFromFile", nextHandle); return nextHandle++; }
+		ShaderHandle CreateShaderFromBinary(const std::string&, ShaderType) override { Log("CreateShaderFromBinary", nextHandle); return nextHandle++; }
+		void DestroyShader(ShaderHandle handle) override { Log("DestroyShader", handle); }
+		void Render() override { Log("Render"); std::this_thread::sleep_for(renderDelay); }
+		void Present() override { Log("Present"); }
+		void FlushCommandQueue() override { Log("FlushCommandQueue"); }
+		std::vector<AdapterDesc> GetDisplayAdapters() const override { return {}; }
+		std::vector<OutputDesc> GetOutputsForAdapter(const AdapterDesc&) const override { return {}; }
+		std::vector<DisplayMode> GetDisplayModesForOutput(const OutputDesc&) const override { return {}; }
+		void SetDisplaySettings(const DisplaySettings& settings) override { Log("SetDisplaySettings"); m_displaySettings = settings; }
+		void SetAntiAliasingSettings(const AntiAliasingSettings& settings) override { Log("SetAntiAliasingSettings"); m_antiAliasingSettings = settings; }
+		void SetTextureSettings(const TextureSettings& settings) override { Log("SetTextureSettings"); m_textureSettings = settings; }
+		void SetShadowSettings(const ShadowSettings& settings) override { Log("SetShadowSettings"); m_shadowSettings = settings; }
+		void SetLightingSettings(const LightingSettings& settings) override { Log("SetLightingSettings"); m_lightingSettings = settings; }
+		void SetPostProcessingSettings(const PostProcessingSettings& settings) override { Log("SetPostProcessingSettings"); m_postProcessingSettings = settings; }
+		void SetPerformanceSettings(const PerformanceSettings& settings) override { Log("SetPerformanceSettings"); m_performanceSettings = settings; }
+		void EnableGPUProfiling(bool enable) noexcept override { profiling = enable; }
+		bool IsGpuProfilingEnabled() const noexcept override { return profiling; }
+		void BeginGpuTimer(GpuTimingPass) noexcept override {}
+		void EndGpuTimer(GpuTimingPass) noexcept override {}
+		float GetGpuFrameTime() const noexcept override { return 0.0f; }
+		float GetGpuTimeForPass(GpuTimingPass) const noexcept override { return 0.0f; }
+		void ResetGpuTimers() noexcept override {}
+	};
+
+	constexpr size_t TextureDataBytes = 32;
+
+	size_t TextureDataSize(const TextureDesc&)
+	{
+		return TextureDataBytes;
+	}
+
+	class RenderCaptureTests : public ::testing::Test
+	{
+	protected:
+		std::filesystem::path m_path;
+		MockRenderer m_recorded{ 100 };
+
+		void SetUp() override
+		{
+			m_path = std::filesystem::temp_directory_path() / (std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) + ".urcp");
+			m_recorded.InitShadowSettings(ShadowSettings{ ShadowSettings::ShadowQuality::ultra, 4096, true });
+		}
+
+		void TearDown() override
+		{
+			std::filesystem::remove(m_path);
+		}
+
+		// Record a frame touching every kind of resource
+		void RecordSequence()
+		{
+			RecordingRenderer recorder(m_recorded, m_path, TextureDataSize);
+			recorder.Initialize(DisplayTarget(nullptr));
+
+			uint8_t data[TextureDataBytes];
+			for (size_t i = 0; i < TextureDataBytes; i++)
+				data[i] = static_cast<uint8_t>(i * 3);
+
+			const BufferHandle buffer = recorder.CreateBuffer(data, 16, BufferUsage::Static, BufferType::Vertex, BufferMemoryType::Default);
+			const BufferHandle vertices = recorder.CreateVertexBuffer(data, 24, VertexLayout::Packed(VertexBounds{ { 1.0f, 2.0f, 3.0f }, { 4.0f, 5.0f, 6.0f } }), BufferUsage::Dynamic, BufferMemoryType::Default);
+			const TextureHandle texture = recorder.CreateTexture(TextureDesc{ 4, 2, 0, 1 }, data);
+			const ShaderHandle shader = recorder.CreateShaderFromSource(std::string("float4 main() : SV_Target { return 1; }"), ShaderType::Pixel);
+
+			recorder.UpdateBuffer(buffer, data + 4, 8, 4);
+			uint8_t* mapped = static_cast<uint8_t*>(recorder.MapBuffer(vertices, 64, 0, MapType::Write));
+			mapped[5] = 0xAB;
+			recorder.UnmapBuffer(vertices);
+			recorder.UpdateTexture(texture, data, 8, TextureUpdateDesc{ 0, 0, 0, 2, 1, 1 });
+
+			uint8_t readBack[12];
+			recorder.ReadBuffer(buffer, readBack, sizeof(readBack), 2);
+
+			recorder.SetDisplaySettings(DisplaySettings{ {}, DisplaySettings::ScreenMode::Borderless, 144, true });
+			recorder.Render();
+			recorder.Present();
+
+			recorder.DestroyShader(shader);
+			recorder.DestroyTexture(texture);
+			recorder.DestroyBuffer(vertices);
+			recorder.DestroyBuffer(buffer);
+			recorder.Flush();
+		}
+
+		std::vector<uint8_t> ReadCapture() const
+		{
+			std::ifstream file(m_path, std::ios::binary);
+			return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		void WriteCapture(const std::vector<uint8_t>& data) const
+		{
+			std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		}
+	};
+}
+
+TEST_F(RenderCaptureTests, ReplayRoundTripsCallsAndPayloads)
+{
+	RecordSequence();
+
+	MockRenderer replayed(5000);
+	CaptureReplayer replayer(m_path);
+	const ReplayReport report = replayer.Replay(replayed, DisplayTarget(nullptr));
+
+	ASSERT_EQ(replayed.calls.size(), m_recorded.calls.size());
+	for (size_t i = 0; i < m_recorded.calls.size(); i++)
+	{
+		EXPECT_EQ(replayed.calls[i].name, m_recorded.calls[i].name) << "call " << i;
+		EXPECT_EQ(replayed.calls[i].bytes, m_recorded.calls[i].bytes) << "call " << i << " " << m_recorded.calls[i].name;
+	}
+
+	EXPECT_EQ(report.frames.size(), 1u);
+	EXPECT_EQ(report.calls[static_cast<size_t>(CaptureCall::Render)].count, 1u);
+	EXPECT_EQ(report.calls[static_cast<size_t>(CaptureCall::InitSettings)].count, 7u);
+}
+
+TEST_F(RenderCaptureTests, ReplayRemapsHandles)
+{
+	RecordSequence();
+
+	MockRenderer replayed(5000);
+	CaptureReplayer(m_path).Replay(replayed, DisplayTarget(nullptr));
+
+	// Every handle the replayed renderer receives is one it created, at the same position as in the recording
+	std::vector<uint64_t> created;
+	for (size_t i = 0; i < replayed.calls.size(); i++)
+	{
+		const MockCall& call = replayed.calls[i];
+		if (call.name.rfind("Create", 0) == 0)
+		{
+			created.push_back(call.handle);
+			EXPECT_EQ(call.handle, m_recorded.calls[i].handle - 100 + 5000);
+		}
+		else if (call.handle)
+		{
+			EXPECT_NE(std::find(created.begin(), created.end(), call.handle), created.end()) << call.name;
+			EXPECT_EQ(call.handle, m_recorded.calls[i].handle - 100 + 5000) << call.name;
+		}
+	}
+	EXPECT_EQ(created.size(), 4u);
+}
+
+TEST_F(RenderCaptureTests, ReplayRestoresSettings)
+{
+	RecordSequence();
+
+	MockRenderer replayed(5000);
+	CaptureReplayer(m_path).Replay(replayed, DisplayTarget(nullptr));
+
+	// Initial settings of the recorded renderer, then the settings changed during the recording
+	EXPECT_EQ(replayed.GetShadowSettings().quality, ShadowSettings::ShadowQuality::ultra);
+	EXPECT_EQ(replayed.GetShadowSettings().mapResolution, 4096);
+	EXPECT_TRUE(replayed.GetShadowSettings().softShadows);
+	EXPECT_EQ(replayed.GetDisplaySettings().mode, DisplaySettings::ScreenMode::Borderless);
+	EXPECT_EQ(replayed.GetDisplaySettings().refreshRate, 144);
+	EXPECT_TRUE(replayed.GetDisplaySettings().vSync);
+}
+
+TEST_F(RenderCaptureTests, ReplayVerifiesReadBack)
+{
+	RecordSequence();
+
+	MockRenderer matching(5000);
+	EXPECT_EQ(CaptureReplayer(m_path).Replay(matching, DisplayTarget(nullptr), true).readBackMismatches, 0u);
+
+	MockRenderer different(5000);
+	different.readPattern = 0x10;
+	EXPECT_EQ(CaptureReplayer(m_path).Replay(different, DisplayTarget(nullptr), true).readBackMismatches, 1u);
+	EXPECT_EQ(CaptureReplayer(m_path).Replay(different, DisplayTarget(nullptr)).readBackMismatches, 0u);
+}
+
+TEST_F(RenderCaptureTests, ReplayTimesPassesFromTheirCalls)
+{
+	{
+		RecordingRenderer recorder(m_recorded, m_path, TextureDataSize);
+		recorder.EnableGPUProfiling(true);
+		recorder.BeginGpuTimer(GpuTimingPass::Frame);
+		recorder.Render();
+		recorder.BeginGpuTimer(GpuTimingPass::GeometryPass);
+		recorder.Render();
+		recorder.EndGpuTimer(GpuTimingPass::GeometryPass);
+		recorder.EndGpuTimer(GpuTimingPass::Frame);
+		recorder.Render();
+		recorder.Present();
+	}
+
+	MockRenderer replayed(5000);
+	replayed.renderDelay = std::chrono::milliseconds(10);
+	const ReplayReport report = CaptureReplayer(m_path).Replay(replayed, DisplayTarget(nullptr));
+	ASSERT_EQ(report.frames.size(), 1u);
+
+	// Each pass holds the Render calls it encloses and none of the ones outside
+	const ReplayFrameStats& frame = report.frames[0];
+	const double geometry = frame.cpuPassMs[static_cast<size_t>(GpuTimingPass::GeometryPass)];
+	const double whole = frame.cpuPassMs[static_cast<size_t>(GpuTimingPass::Frame)];
+	EXPECT_GE(geometry, 10.0);
+	EXPECT_GE(whole, geometry + 10.0);
+	EXPECT_LE(whole, frame.cpuMs - 10.0);
+	EXPECT_EQ(frame.cpuPassMs[static_cast<size_t>(GpuTimingPass::ShadowPass)], 0.0);
+}
+
+TEST_F(RenderCaptureTests, RecorderRequiresTextureDataSize)
+{
+	EXPECT_THROW(RecordingRenderer(m_recorded, m_path, nullptr), std::invalid_argument);
+}
+
+TEST_F(RenderCaptureTests, TruncatedCaptureThrows)
+{
+	RecordSequence();
+	const std::vector<uint8_t> capture = ReadCapture();
+
+	// Cut inside the last record's payload and inside its header
+	for (const size_t cut : { size_t(3), size_t(9) })
+	{
+		WriteCapture(std::vector<uint8_t>(capture.begin(), capture.end() - cut));
+
+		MockRenderer replayed(5000);
+		CaptureReplayer replayer(m_path);
+		EXPECT_THROW(replayer.Replay(replayed, DisplayTarget(nullptr)), std::runtime_error) << "cut " << cut;
+	}
+
+	// Shorter than the file header
+	WriteCapture(std::vector<uint8_t>(capture.begin(), capture.begin() + 5));
+	EXPECT_THROW(CaptureReplayer{ m_path }, std::runtime_error);
+}
+
+TEST_F(RenderCaptureTests, GarbledCaptureThrows)
+{
+	RecordSequence();
+	const std::vector<uint8_t> capture = ReadCapture();
+
+	// Wrong magic
+	std::vector<uint8_t> garbled = capture;
+	garbled[0] = 'X';
+	WriteCapture(garbled);
+	EXPECT_THROW(CaptureReplayer{ m_path }, std::runtime_error);
+
+	// Unsupported version
+	garbled = capture;
+	garbled[sizeof(CaptureFormat::Magic)] = 0xFF;
+	WriteCapture(garbled);
+	EXPECT_THROW(CaptureReplayer{ m_path }, std::runtime_error);
+
+	// Unknown call in the first record
+	garbled = capture;
+	garbled[CaptureFormat::HeaderSize] = static_cast<uint8_t>(CaptureCall::Count);
+	WriteCapture(garbled);
+	{
+		MockRenderer replayed(5000);
+		CaptureReplayer replayer(m_path);
+		EXPECT_THROW(replayer.Replay(replayed, DisplayTarget(nullptr)), std::runtime_error);
+	}
+
+	// Payload size pointing past the end of the file
+	garbled = capture;
+	const uint64_t size = UINT64_MAX / 2;
+	std::memcpy(garbled.data() + CaptureFormat::HeaderSize + sizeof(CaptureCall), &size, sizeof(size));
+	WriteCapture(garbled);
+	{
+		MockRenderer replayed(5000);
+		CaptureReplayer replayer(m_path);
+		EXPECT_THROW(replayer.Replay(replayed, DisplayTarget(nullptr)), std::runtime_error);
+	}
+
+	// Vertex layout with more attributes than a VertexLayout holds
+	MockRenderer recorded(100);
+	{
+		RecordingRenderer recorder(recorded, m_path, TextureDataSize);
+		recorder.CreateVertexBuffer(nullptr, 0, VertexLayout::Standard(), BufferUsage::Static, BufferMemoryType::Default);
+	}
+	garbled = ReadCapture();
+	garbled[CaptureFormat::HeaderSize + CaptureFormat::RecordHeaderSize + sizeof(BufferHandle) + sizeof(BufferUsage) + sizeof(BufferMemoryType)] = VertexLayout::MaxAttributes + 1;
+	WriteCapture(garbled);
+	{
+		MockRenderer replayed(5000);
+		CaptureReplayer replayer(m_path);
+		EXPECT_THROW(replayer.Replay(replayed, DisplayTarget(nullptr)), std::runtime_error);
+	}
+
+	// Reference to a buffer that was never created
+	{
+		RecordingRenderer recorder(recorded, m_path, TextureDataSize);
+		recorder.DestroyBuffer(BufferHandle(42));
+	}
+	{
+		MockRenderer replayed(5000);
+		CaptureReplayer replayer(m_path);
+		EXPECT_THROW(replayer.Replay(replayed, DisplayTarget(nullptr)), std::runtime_error);
+	}
+}
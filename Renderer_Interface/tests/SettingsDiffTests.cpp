@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <IRenderer_SettingsDiff.h>
+
+using namespace UltReality::Rendering;
+
+TEST(SettingsDiff, UnchangedSettingsInvalidateNothing)
+{
+	const DisplaySettings display{ { 1920, 1080 }, DisplaySettings::ScreenMode::Fullscreen, 144, true };
+	const PerformanceSettings performance{ true, { 960, 540 }, { 1920, 1080 } };
+
+	EXPECT_EQ(DiffSettings(display, display), RenderResource::None);
+	EXPECT_EQ(DiffSettings(performance, performance), RenderResource::None);
+}
+
+TEST(SettingsDiff, RenderResolutionChangesInvalidateTheSameTargets)
+{
+	const DisplaySettings display{ { 1920, 1080 }, DisplaySettings::ScreenMode::Fullscreen, 144, true };
+	DisplaySettings resized = display;
+	resized.resolution = { 2560, 1440 };
+	const RebuildMask displayMask = DiffSettings(display, resized);
+	EXPECT_EQ(displayMask & RenderResource::RenderResolutionTargets, RenderResource::RenderResolutionTargets);
+	EXPECT_TRUE(displayMask & RenderResource::SwapChain);
+
+	// Growing the dynamic resolution range reallocates every render resolution target, without touching the swap chain
+	const PerformanceSettings performance{ true, { 960, 540 }, { 1920, 1080 } };
+	PerformanceSettings larger = performance;
+	larger.maxResolution = { 2560, 1440 };
+	EXPECT_EQ(DiffSettings(performance, larger), RebuildMask(RenderResource::RenderResolutionTargets));
+
+	// Toggling dynamic resolution changes the allocation size and the upscaling permutations
+	PerformanceSettings fixed = performance;
+	fixed.dynamicResolution = false;
+	EXPECT_EQ(DiffSettings(performance, fixed), RebuildMask(RenderResource::RenderResolutionTargets | RenderResource::PipelineStates));
+	EXPECT_EQ(DiffSettings(fixed, performance), DiffSettings(performance, fixed));
+}
+
+TEST(SettingsDiff, ResolutionLimitsOnlyMatterWithDynamicResolution)
+{
+	const PerformanceSettings fixed{ false, { 960, 540 }, { 1920, 1080 } };
+	PerformanceSettings changed = fixed;
+	changed.minResolution = { 640, 360 };
+	changed.maxResolution = { 2560, 1440 };
+	EXPECT_EQ(DiffSettings(fixed, changed), RenderResource::None);
+
+	// The minimum only bounds the per-frame scale
+	const PerformanceSettings dynamic{ true, { 960, 540 }, { 1920, 1080 } };
+	PerformanceSettings lower = dynamic;
+	lower.minResolution = { 640, 360 };
+	EXPECT_EQ(DiffSettings(dynamic, lower), RebuildMask(RenderResource::FrameConstants));
+}
+
+TEST(SettingsDiff, PresentOnlyDisplayChanges)
+{
+	const DisplaySettings display{ { 1920, 1080 }, DisplaySettings::ScreenMode::Fullscreen, 144, true };
+
+	DisplaySettings next = display;
+	next.vSync = false;
+	EXPECT_EQ(DiffSettings(display, next), RebuildMask(RenderResource::FrameConstants));
+
+	next = display;
+	next.mode = DisplaySettings::ScreenMode::Borderless;
+	EXPECT_EQ(DiffSettings(display, next), RebuildMask(RenderResource::SwapChain));
+}